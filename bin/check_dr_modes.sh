@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Routes the mock example once per detailed routing mode and checks that
+# every run solves both the power and the signal nets, i.e. all nets are
+# routed and pass the DRC check of the last rip-up and reroute iteration.
+# usage: ./check_dr_modes.sh [threads]
+
+threads=${1:-4}
+status=0
+
+run() {
+  local mode=$1
+  shift
+  ./anaroute --tech_lef ../mockPDK/mock.lef \
+             --tech_file ../mockPDK/mock.techfile \
+             --design_file ../mockPDK/mock.netlist \
+             --placement_layout ../mockPDK/mock.place.gds \
+             --iopin ../mockPDK/mock.iopin \
+             --spec ../mockPDK/mock.spec \
+             --out mock.$mode.route.gds \
+             "$@" > mock.$mode.log 2>&1
+  if [ $? -ne 0 ]; then
+    echo "$mode: anaroute exited abnormally, see mock.$mode.log"
+    status=1
+  elif grep -q "DR Failed" mock.$mode.log || [ $(grep -c "Solved" mock.$mode.log) -ne 2 ]; then
+    echo "$mode: unrouted nets or DRC violations, see mock.$mode.log"
+    status=1
+  else
+    echo "$mode: routed, DRC clean"
+  fi
+}
+
+run serial
+run optimistic --threads $threads --optimistic
+run portfolio --threads $threads --portfolio
+run box_heuristic --box_heuristic
+run bidirectional --bidirectional
+run bin_grid --bin_grid
+
+exit $status
@@ -167,11 +167,14 @@ namespace apiPy {
     /////////////////////////////////////
     // solve
     /////////////////////////////////////
-    bool solve(const bool bUseSymFile = false) {
+    bool solve(const bool bUseSymFile = false, const Int_t numThreads = 1, const Int_t numTrials = 1,
+               const bool bOptimistic = false, const bool bPortfolio = false, const Int_t numPortfolioThreads = 0,
+               const bool bBoxHeuristic = false, const bool bBidirectional = false, const bool bBinGrid = false) {
       TimeUsage timer;
       timer.start(TimeUsage::FULL);
       _cir.resizeVVPinIndices(_cir.lef().numLayers());
       _cir.resizeVVBlkIndices(_cir.lef().numLayers());
+      _cir.setRoutedWireBinGrid(bBinGrid);
       _cir.buildSpatial();
       _cir.markBlks();
       _cir.checkNetSymSelfSym();
@@ -186,7 +189,12 @@ namespace apiPy {
 
       DrcMgr drc(_cir);
       DrMgr dr(_cir, drc);
-      if (!dr.solve(true, bUseSymFile))
+      dr.setOptimistic(bOptimistic);
+      dr.setPortfolio(bPortfolio);
+      dr.setNumPortfolioThreads(numPortfolioThreads);
+      dr.setBoxHeuristic(bBoxHeuristic);
+      dr.setBidirectional(bBidirectional);
+      if (!dr.solve(true, bUseSymFile, numThreads, numTrials))
         return false;
 
       PostMgr post(_cir);
@@ -199,7 +207,6 @@ namespace apiPy {
     }
 
     void init() {
-      std::srand(1234);
       _cir.resizeVVPinIndices(_cir.lef().numLayers());
       _cir.resizeVVBlkIndices(_cir.lef().numLayers());
       _par.correctPinNBlkLoc();
@@ -300,7 +307,10 @@ void initPyAPI(py::module& m) {
     .def("addSelfSymNet", py::overload_cast<const pro::String_t&>(&apiPy::AnaroutePy::addSelfSymNet))
     .def("addSelfSymNet", py::overload_cast<const pro::UInt_t>(&apiPy::AnaroutePy::addSelfSymNet))
     .def("addIOPort", &apiPy::AnaroutePy::addIOPort)
-    .def("solve", &apiPy::AnaroutePy::solve)
+    .def("solve", &apiPy::AnaroutePy::solve, py::arg("bUseSymFile") = false, py::arg("numThreads") = 1, py::arg("numTrials") = 1,
+         py::arg("bOptimistic") = false, py::arg("bPortfolio") = false, py::arg("numPortfolioThreads") = 0,
+         py::arg("bBoxHeuristic") = false, py::arg("bBidirectional") = false,
+         py::arg("bBinGrid") = false)
     .def("init", &apiPy::AnaroutePy::init)
     .def("solveGR", &apiPy::AnaroutePy::solveGR)
     .def("solveDR", &apiPy::AnaroutePy::solveDR)
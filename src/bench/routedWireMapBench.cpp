@@ -0,0 +1,158 @@
+/**
+ * @file   routedWireMapBench.cpp
+ * @brief  Benchmark - R-tree vs bin grid routed wire index
+ *
+ * Checks the bin grid against the R-tree on random insert / erase / query
+ * sequences, then times both on a rip-up and reroute like workload.
+ * Exits with 1 if the two indices ever disagree.
+ *
+ * usage: routedWireMapBench [numOps] [numWires] [numQueries] [seed]
+ **/
+
+#include "src/db/dbRoutedWireMap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace PROJECT_NAMESPACE;
+
+namespace {
+
+constexpr Int_t kGridStep   = 100;
+constexpr Int_t kNumGrids   = 1000;
+constexpr Int_t kBound      = kGridStep * kNumGrids;
+constexpr Int_t kHalfWidth  = 20;
+constexpr Int_t kBinGrids   = 4;        // same as CirDB
+constexpr UInt_t kNumNets   = 2000;
+
+// grid-aligned wire of 1 to 6 grids, horizontal or vertical
+Box<Int_t> randWire(std::mt19937& rng) {
+  const Int_t x = rng() % kNumGrids * kGridStep;
+  const Int_t y = rng() % kNumGrids * kGridStep;
+  const Int_t len = (1 + rng() % 6) * kGridStep;
+  if (rng() % 2)
+    return Box<Int_t>(x - kHalfWidth, y - kHalfWidth, std::min(x + len, kBound) + kHalfWidth, y + kHalfWidth);
+  return Box<Int_t>(x - kHalfWidth, y - kHalfWidth, x + kHalfWidth, std::min(y + len, kBound) + kHalfWidth);
+}
+
+void initMap(RoutedWireMap& map, const bool bBinGrid) {
+  if (bBinGrid)
+    map.initBinGrid(Box<Int_t>(0, 0, kBound, kBound), kBinGrids * kGridStep);
+  else
+    map.initRtree();
+}
+
+double elapsedMs(const std::chrono::steady_clock::time_point& t) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+}
+
+// same operations on both indices, every query compared
+bool crossCheck(const Int_t numOps, const UInt_t seed) {
+  std::mt19937 rng(seed);
+  RoutedWireMap rtree, binGrid;
+  initMap(rtree, false);
+  initMap(binGrid, true);
+  Vector_t<Pair_t<Box<Int_t>, UInt_t>> vLive;
+  for (Int_t i = 0; i < numOps; ++i) {
+    const Int_t op = rng() % 4;
+    if (op < 2 or vLive.empty()) {
+      const Box<Int_t> wire = randWire(rng);
+      const UInt_t netIdx = rng() % kNumNets;
+      rtree.insert(wire, netIdx);
+      binGrid.insert(wire, netIdx);
+      vLive.emplace_back(wire, netIdx);
+    }
+    else if (op == 2) {
+      const UInt_t j = rng() % vLive.size();
+      const bool bRtree = rtree.erase(vLive[j].first, vLive[j].second);
+      const bool bBinGrid = binGrid.erase(vLive[j].first, vLive[j].second);
+      if (!bRtree or !bBinGrid) {
+        fprintf(stderr, "op %d: erase mismatch\n", i);
+        return false;
+      }
+      vLive[j] = vLive.back();
+      vLive.pop_back();
+    }
+    else {
+      Box<Int_t> query = randWire(rng);
+      query.expand(rng() % 300);
+      const UInt_t netIdx = rng() % kNumNets;
+      auto bOtherNet = [netIdx] (const Box<Int_t>& box, const UInt_t idx) { return idx != netIdx; };
+      Vector_t<Pair_t<Box<Int_t>, UInt_t>> vRtree, vBinGrid;
+      rtree.queryBoth(query, vRtree);
+      binGrid.queryBoth(query, vBinGrid);
+      std::sort(vRtree.begin(), vRtree.end());
+      std::sort(vBinGrid.begin(), vBinGrid.end());
+      if (vRtree != vBinGrid
+          or rtree.count(query) != binGrid.count(query)
+          or rtree.exist(query) != binGrid.exist(query)
+          or rtree.exist(query, bOtherNet) != binGrid.exist(query, bOtherNet)) {
+        fprintf(stderr, "op %d: query mismatch\n", i);
+        return false;
+      }
+    }
+  }
+  if (rtree.size() != binGrid.size()) {
+    fprintf(stderr, "size mismatch %zu %zu\n", rtree.size(), binGrid.size());
+    return false;
+  }
+  return true;
+}
+
+// fill, DRC-like queries against other nets, then rip-up and reroute
+void bench(const bool bBinGrid, const Int_t numWires, const Int_t numQueries, const UInt_t seed) {
+  std::mt19937 rng(seed);
+  RoutedWireMap map;
+  initMap(map, bBinGrid);
+  Vector_t<Pair_t<Box<Int_t>, UInt_t>> vLive;
+  vLive.reserve(numWires);
+
+  auto t = std::chrono::steady_clock::now();
+  for (Int_t i = 0; i < numWires; ++i) {
+    vLive.emplace_back(randWire(rng), rng() % kNumNets);
+    map.insert(vLive.back().first, vLive.back().second);
+  }
+  const double insertMs = elapsedMs(t);
+
+  t = std::chrono::steady_clock::now();
+  Int_t numHits = 0;
+  for (Int_t i = 0; i < numQueries; ++i) {
+    Box<Int_t> query = randWire(rng);
+    query.expand(3 * kHalfWidth);
+    const UInt_t netIdx = rng() % kNumNets;
+    numHits += map.exist(query, [netIdx] (const Box<Int_t>& box, const UInt_t idx) { return idx != netIdx; });
+  }
+  const double queryMs = elapsedMs(t);
+
+  t = std::chrono::steady_clock::now();
+  for (Int_t i = 0; i < numWires; ++i) {
+    auto& wire = vLive[rng() % vLive.size()];
+    map.erase(wire.first, wire.second);
+    wire.first = randWire(rng);
+    map.insert(wire.first, wire.second);
+  }
+  const double ripupMs = elapsedMs(t);
+
+  printf("%-8s  insert %8.1f ms  exist %8.1f ms (%d hits)  rip-up %8.1f ms\n",
+         bBinGrid ? "bin grid" : "rtree", insertMs, queryMs, numHits, ripupMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const Int_t numOps     = argc > 1 ? atoi(argv[1]) : 200000;
+  const Int_t numWires   = argc > 2 ? atoi(argv[2]) : 200000;
+  const Int_t numQueries = argc > 3 ? atoi(argv[3]) : 2000000;
+  const UInt_t seed      = argc > 4 ? atoi(argv[4]) : 7;
+
+  if (!crossCheck(numOps, seed))
+    return 1;
+  printf("cross-check: %d random ops, bin grid matches rtree\n", numOps);
+
+  bench(false, numWires, numQueries, seed);
+  bench(true, numWires, numQueries, seed);
+  return 0;
+}
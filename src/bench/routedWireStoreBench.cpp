@@ -0,0 +1,159 @@
+/**
+ * @file   routedWireStoreBench.cpp
+ * @brief  Benchmark - routed wire snapshots under concurrent readers
+ *
+ * One writer commits and rips up nets of a fixed number of wires and
+ * publishes after each of them, like optimistic routing does, while reader
+ * threads query the snapshots. Every snapshot must hold whole nets only,
+ * answer the same queries as long as it is held, and keep its cover raster
+ * dirty under every wire it holds.
+ * Exits with 1 on the first violation.
+ *
+ * usage: routedWireStoreBench [numCommits] [numReaders] [seed]
+ **/
+
+#include "src/db/dbRoutedWireStore.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+using namespace PROJECT_NAMESPACE;
+
+namespace {
+
+constexpr Int_t kGridStep     = 100;
+constexpr Int_t kNumGrids     = 500;
+constexpr Int_t kBound        = kGridStep * kNumGrids;
+constexpr Int_t kHalfWidth    = 20;
+constexpr Int_t kClearance    = 30;
+constexpr Int_t kTileSize     = 64 * kGridStep; // same as CirDB
+constexpr Int_t kNumLayers    = 3;
+constexpr Int_t kWiresPerNet  = 6;
+constexpr Int_t kNumLiveNets  = 3000;         // rip up an old net beyond this
+
+// grid-aligned wire of 1 to 6 grids, horizontal or vertical
+Box<Int_t> randWire(std::mt19937& rng) {
+  const Int_t x = rng() % kNumGrids * kGridStep;
+  const Int_t y = rng() % kNumGrids * kGridStep;
+  const Int_t len = (1 + rng() % 6) * kGridStep;
+  if (rng() % 2)
+    return Box<Int_t>(x - kHalfWidth, y - kHalfWidth, std::min(x + len, kBound) + kHalfWidth, y + kHalfWidth);
+  return Box<Int_t>(x - kHalfWidth, y - kHalfWidth, x + kHalfWidth, std::min(y + len, kBound) + kHalfWidth);
+}
+
+double elapsedMs(const std::chrono::steady_clock::time_point& t) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+}
+
+// returns false if the snapshot holds a partial net or a clean raster cell under a wire
+bool checkSnapshot(const RoutedWireStore::Snapshot& snapshot, Vector_t<Int_t>& vNetWires) {
+  const Box<Int_t> die(-kBound, -kBound, 2 * kBound, 2 * kBound);
+  std::fill(vNetWires.begin(), vNetWires.end(), 0);
+  size_t numWires = 0;
+  bool bValid = true;
+  for (UInt_t layerIdx = 0; layerIdx < snapshot.numLayers(); ++layerIdx) {
+    const RoutedWireLayer& layer = snapshot.layer(layerIdx);
+    numWires += layer.size();
+    layer.visit(die, [&] (const Box<Int_t>& box, const UInt_t netIdx) {
+      ++vNetWires[netIdx];
+      bValid = bValid and !snapshot.coverRaster().bClean(layerIdx, box);
+    });
+  }
+  size_t numVisited = 0;
+  for (const Int_t n : vNetWires) {
+    if (n != 0 and n != kWiresPerNet)
+      return false;
+    numVisited += n;
+  }
+  return bValid and numVisited == numWires;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const Int_t numCommits = argc > 1 ? atoi(argv[1]) : 20000;
+  const Int_t numReaders = argc > 2 ? atoi(argv[2]) : 4;
+  const UInt_t seed      = argc > 3 ? atoi(argv[3]) : 7;
+
+  RoutedWireStore store;
+  store.init(kNumLayers, Box<Int_t>(0, 0, kBound, kBound), kTileSize, 0);
+  store.coverRaster().init(Box<Int_t>(0, 0, kBound, kBound), kGridStep, Vector_t<Int_t>(kNumLayers, kClearance));
+  store.publish();
+
+  std::atomic<bool> bDone(false);
+  std::atomic<bool> bFailed(false);
+  std::atomic<long> numReads(0);
+  Vector_t<std::thread> vReaders;
+  for (Int_t r = 0; r < numReaders; ++r) {
+    vReaders.emplace_back([&, r] {
+      std::mt19937 rng(seed + 1 + r);
+      Vector_t<Int_t> vNetWires(numCommits, 0);
+      RoutedWireStore::SnapshotPtr pHeld = store.snapshot();
+      Box<Int_t> heldQuery = randWire(rng);
+      size_t heldCount = pHeld->layer(0).count(heldQuery);
+      UInt_t lastEpoch = pHeld->epoch();
+      while (!bDone and !bFailed) {
+        RoutedWireStore::SnapshotPtr pSnapshot = store.snapshot();
+        if (pSnapshot->epoch() < lastEpoch or !checkSnapshot(*pSnapshot, vNetWires)) {
+          fprintf(stderr, "reader %d: invalid snapshot at epoch %u\n", r, pSnapshot->epoch());
+          bFailed = true;
+          return;
+        }
+        lastEpoch = pSnapshot->epoch();
+        // a held snapshot never sees later commits
+        if (pHeld->layer(0).count(heldQuery) != heldCount) {
+          fprintf(stderr, "reader %d: snapshot of epoch %u changed\n", r, pHeld->epoch());
+          bFailed = true;
+          return;
+        }
+        if (++numReads % 8 == 0) {
+          pHeld = pSnapshot;
+          heldQuery = randWire(rng);
+          heldQuery.expand(rng() % 2000);
+          heldCount = pHeld->layer(0).count(heldQuery);
+        }
+      }
+    });
+  }
+
+  std::mt19937 rng(seed);
+  Vector_t<Vector_t<Pair_t<Box<Int_t>, Int_t>>> vvNetWires(numCommits);
+  Vector_t<Int_t> vLiveNets;
+  auto t = std::chrono::steady_clock::now();
+  for (Int_t netIdx = 0; netIdx < numCommits and !bFailed; ++netIdx) {
+    for (Int_t i = 0; i < kWiresPerNet; ++i) {
+      vvNetWires[netIdx].emplace_back(randWire(rng), rng() % kNumLayers);
+      store.insert(vvNetWires[netIdx].back().second, vvNetWires[netIdx].back().first, netIdx);
+    }
+    vLiveNets.emplace_back(netIdx);
+    store.publish();
+    if ((Int_t)vLiveNets.size() > kNumLiveNets) {
+      const Int_t j = rng() % vLiveNets.size();
+      for (const auto& pair : vvNetWires[vLiveNets[j]]) {
+        if (!store.erase(pair.second, pair.first, vLiveNets[j])) {
+          fprintf(stderr, "net %d: erase failed\n", vLiveNets[j]);
+          bFailed = true;
+        }
+      }
+      vLiveNets[j] = vLiveNets.back();
+      vLiveNets.pop_back();
+      store.publish();
+    }
+  }
+  const double commitMs = elapsedMs(t);
+  bDone = true;
+  for (std::thread& reader : vReaders) {
+    reader.join();
+  }
+  if (bFailed)
+    return 1;
+
+  printf("%d commits with %d readers: %.1f us per commit and publish, %ld snapshots checked\n",
+         numCommits, numReaders, commitMs * 1000 / numCommits, (long)numReads);
+  return 0;
+}
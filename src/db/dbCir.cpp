@@ -17,7 +17,9 @@ PROJECT_NAMESPACE_START
 void CirDB::buildSpatial() {
   buildSpatialPins();
   buildSpatialBlks();
+  buildSpatialOD();
   initSpatialRoutedWires();
+  buildCoverRaster();
 }
 
 void CirDB::buildSpatialPins() {
@@ -55,30 +57,99 @@ void CirDB::buildSpatialBlks() {
 
 void CirDB::buildSpatialNetGuides() {
   _vvSpatialNetGuides.resize(_vNets.size());
-  UInt_t i;
+  Vector_t<Vector_t<spatial::b_box<Int_t>>> vvShapes(_lef.numLayers());
+  UInt_t i, layerIdx;
   const Net* cpNet;
   Cir_ForEachNetC((*this), cpNet, i) {
     const Vector_t<Pair_t<Box<Int_t>, Int_t>>& vGuides = cpNet->vGuides();
-    _vvSpatialNetGuides[i].resize(_lef.numLayers());
     for (const Pair_t<Box<Int_t>, Int_t>& pair : vGuides) {
-      _vvSpatialNetGuides[i][pair.second].insert(pair.first);
+      vvShapes[pair.second].emplace_back(pair.first.bl(), pair.first.tr());
+    }
+    _vvSpatialNetGuides[i].resize(_lef.numLayers());
+    Cir_ForEachLayerIdx((*this), layerIdx) {
+      _vvSpatialNetGuides[i][layerIdx] = Spatial<Int_t>(vvShapes[layerIdx]);
+      vvShapes[layerIdx].clear();
     }
   }
+  // grid point membership for the grid-based routers
+  _vNetGuideMaps.resize(_vNets.size());
+  Cir_ForEachNetC((*this), cpNet, i) {
+    _vNetGuideMaps[i].init(_lef.numLayers(), _gridStep, _gridOffsetX, _gridOffsetY, cpNet->vGuides());
+  }
+}
+
+void CirDB::buildSpatialOD() {
+  _spatialOD = Spatial<Int_t>(_vODShapes);
 }
 
 void CirDB::initSpatialRoutedWires() {
-  _vSpatialRoutedWires.resize(_lef.numLayers());
+  // a bin holds a few grid points, about a wire plus its spacing;
+  // a tile is what a commit copies at most per touched region
+  const Int_t binSize = _bRoutedWireBinGrid ? 4 * _gridStep : 0;
+  _spatialRoutedWires.init(_lef.numLayers(), Box<Int_t>(_xl, _yl, _xh, _yh), 64 * _gridStep, binSize);
+}
+
+void CirDB::buildCoverRaster() {
+  // bloat each shape by the largest spacing of its layer
+  Vector_t<Int_t> vClearances(_lef.numLayers(), 0);
+  UInt_t i, j, layerIdx;
+  Cir_ForEachLayerIdx((*this), layerIdx) {
+    const Pair_t<LefLayerType, UInt_t>& layerPair = _lef.layerPair(layerIdx);
+    if (_lef.bRoutingLayer(layerIdx)) {
+      const LefRoutingLayer& layer = _lef.routingLayer(layerPair.second);
+      for (const auto& table : layer.spacingTable().table) {
+        for (const Int_t s : table.second) {
+          vClearances[layerIdx] = std::max(vClearances[layerIdx], s);
+        }
+      }
+      if (layer.numSpacings()) {
+        vClearances[layerIdx] = std::max(vClearances[layerIdx], layer.spacing(0));
+      }
+    }
+    else if (_lef.bCutLayer(layerIdx)) {
+      vClearances[layerIdx] = _lef.cutLayer(layerPair.second).spacing();
+    }
+  }
+  CoverRaster& coverRaster = _spatialRoutedWires.coverRaster();
+  coverRaster.init(Box<Int_t>(_xl, _yl, _xh, _yh), _gridStep, vClearances);
+
+  const Pin* cpPin;
+  const Box<Int_t>* cpBox;
+  Cir_ForEachPinC((*this), cpPin, i) {
+    Pin_ForEachLayerIdx((*cpPin), layerIdx) {
+      Pin_ForEachLayerBoxC((*cpPin), layerIdx, cpBox, j) {
+        coverRaster.insert(layerIdx, *cpBox);
+      }
+    }
+  }
+  const Blk* cpBlk;
+  Cir_ForEachLayerIdx((*this), layerIdx) {
+    Cir_ForEachLayerBlkC((*this), layerIdx, cpBlk, i) {
+      coverRaster.insert(layerIdx, cpBlk->box());
+    }
+  }
+}
+
+void CirDB::publishRoutedWires() {
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  _spatialRoutedWires.publish();
+}
+
+bool CirDB::bCoverRasterClean(const UInt_t layerIdx, const Box<Int_t>& box) const {
+  std::shared_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  return _spatialRoutedWires.coverRaster().bClean(layerIdx, box);
 }
 
 void CirDB::addSpatialOD(const Box<Int_t> &box)
 {
-    _spatialOD.insert(box);
+    _vODShapes.emplace_back(box.bl(), box.tr());
 }
 
 void CirDB::addSpatialRoutedWire(const UInt_t netIdx, const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   assert(u.z() == v.z());
   const UInt_t layerIdx = u.z();
-  assert(layerIdx >= 0 and layerIdx < _vSpatialRoutedWires.size());
+  assert(layerIdx >= 0 and layerIdx < _spatialRoutedWires.numLayers());
   assert(_lef.bRoutingLayer(layerIdx) or _lef.bMastersliceLayer(layerIdx));
   const Pair_t<LefLayerType, UInt_t>& layerPair = _lef.layerPair(layerIdx);
   const LefRoutingLayer& routingLayer = _lef.routingLayer(layerPair.second);
@@ -87,16 +158,16 @@ void CirDB::addSpatialRoutedWire(const UInt_t netIdx, const Point3d<Int_t>& u, c
   const Int_t xh = std::max(u.x(), v.x()) + halfWidth;
   const Int_t yl = std::min(u.y(), v.y()) - halfWidth;
   const Int_t yh = std::max(u.y(), v.y()) + halfWidth;
-  const Point<Int_t> min_corner(xl, yl);
-  const Point<Int_t> max_corner(xh, yh);
-  _vSpatialRoutedWires[layerIdx].insert(min_corner, max_corner, netIdx);
+  _spatialRoutedWires.insert(layerIdx, Box<Int_t>(xl, yl, xh, yh), netIdx);
 }
 
 void CirDB::addSpatialRoutedWire(const UInt_t netIdx, const UInt_t layerIdx, const Box<Int_t>& box) {
-  _vSpatialRoutedWires[layerIdx].insert(box, netIdx);
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  _spatialRoutedWires.insert(layerIdx, box, netIdx);
 }
 
 void CirDB::addSpatialRoutedVia(const UInt_t netIdx, const UInt_t viaIdx, const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   assert(u.x() == v.x() and u.y() == v.y());
   const Int_t x = u.x();
   const Int_t y = u.y();
@@ -109,40 +180,42 @@ void CirDB::addSpatialRoutedVia(const UInt_t netIdx, const UInt_t viaIdx, const
   for (const Box<Int_t>& box : via.vBotBoxes()) {
     Box<Int_t> shift_box(box);
     shift_box.shift(x, y);
-    _vSpatialRoutedWires[botLayerIdx].insert(shift_box, netIdx);
+    _spatialRoutedWires.insert(botLayerIdx, shift_box, netIdx);
   }
   for (const Box<Int_t>& box : via.vCutBoxes()) {
     Box<Int_t> shift_box(box);
     shift_box.shift(x, y);
-    _vSpatialRoutedWires[cutLayerIdx].insert(shift_box, netIdx);
+    _spatialRoutedWires.insert(cutLayerIdx, shift_box, netIdx);
   }
   for (const Box<Int_t>& box : via.vTopBoxes()) {
     Box<Int_t> shift_box(box);
     shift_box.shift(x, y);
-    _vSpatialRoutedWires[topLayerIdx].insert(shift_box, netIdx);
+    _spatialRoutedWires.insert(topLayerIdx, shift_box, netIdx);
   }
   
 }
 
 void CirDB::addSpatialRoutedVia(const Int_t netIdx, const Int_t x, const Int_t y, const LefVia& via) {
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   for (auto box : via.vBotBoxes()) {
     box.shift(x, y);
-    _vSpatialRoutedWires[via.botLayerIdx()].insert(box, netIdx);
+    _spatialRoutedWires.insert(via.botLayerIdx(), box, netIdx);
   }
   for (auto box : via.vCutBoxes()) {
     box.shift(x, y);
-    _vSpatialRoutedWires[via.cutLayerIdx()].insert(box, netIdx);
+    _spatialRoutedWires.insert(via.cutLayerIdx(), box, netIdx);
   }
   for (auto box : via.vTopBoxes()) {
     box.shift(x, y);
-    _vSpatialRoutedWires[via.topLayerIdx()].insert(box, netIdx);
+    _spatialRoutedWires.insert(via.topLayerIdx(), box, netIdx);
   }
 }
 
 bool CirDB::removeSpatialRoutedWire(const UInt_t netIdx, const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   assert(u.z() == v.z());
   const UInt_t layerIdx = u.z();
-  assert(layerIdx >= 0 and layerIdx < _vSpatialRoutedWires.size());
+  assert(layerIdx >= 0 and layerIdx < _spatialRoutedWires.numLayers());
   assert(_lef.bRoutingLayer(layerIdx) or _lef.bMastersliceLayer(layerIdx));
   const Pair_t<LefLayerType, UInt_t>& layerPair = _lef.layerPair(layerIdx);
   const LefRoutingLayer& routingLayer = _lef.routingLayer(layerPair.second);
@@ -151,16 +224,16 @@ bool CirDB::removeSpatialRoutedWire(const UInt_t netIdx, const Point3d<Int_t>& u
   const Int_t xh = std::max(u.x(), v.x()) + halfWidth;
   const Int_t yl = std::min(u.y(), v.y()) - halfWidth;
   const Int_t yh = std::max(u.y(), v.y()) + halfWidth;
-  const Point<Int_t> min_corner(xl, yl);
-  const Point<Int_t> max_corner(xh, yh);
-  return _vSpatialRoutedWires[layerIdx].erase(min_corner, max_corner, netIdx);
+  return _spatialRoutedWires.erase(layerIdx, Box<Int_t>(xl, yl, xh, yh), netIdx);
 }
 
 bool CirDB::removeSpatialRoutedWire(const UInt_t netIdx, const UInt_t layerIdx, const Box<Int_t>& box) {
-  return _vSpatialRoutedWires[layerIdx].erase(box, netIdx);
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  return _spatialRoutedWires.erase(layerIdx, box, netIdx);
 }
 
 bool CirDB::removeSpatialRoutedVia(const UInt_t netIdx, const UInt_t viaIdx, const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   assert(u.x() == v.x() and u.y() == v.y());
   const Int_t x = u.x();
   const Int_t y = u.y();
@@ -174,34 +247,35 @@ bool CirDB::removeSpatialRoutedVia(const UInt_t netIdx, const UInt_t viaIdx, con
   for (const Box<Int_t>& box : via.vBotBoxes()) {
     Box<Int_t> shift_box(box);
     shift_box.shift(x, y);
-    ret &= _vSpatialRoutedWires[botLayerIdx].erase(shift_box, netIdx);
+    ret &= _spatialRoutedWires.erase(botLayerIdx, shift_box, netIdx);
   }
   for (const Box<Int_t>& box : via.vCutBoxes()) {
     Box<Int_t> shift_box(box);
     shift_box.shift(x, y);
-    ret &= _vSpatialRoutedWires[cutLayerIdx].erase(shift_box, netIdx);
+    ret &= _spatialRoutedWires.erase(cutLayerIdx, shift_box, netIdx);
   }
   for (const Box<Int_t>& box : via.vTopBoxes()) {
     Box<Int_t> shift_box(box);
     shift_box.shift(x, y);
-    ret &= _vSpatialRoutedWires[topLayerIdx].erase(shift_box, netIdx);
+    ret &= _spatialRoutedWires.erase(topLayerIdx, shift_box, netIdx);
   }
   return ret;
 }
 
 bool CirDB::removeSpatialRoutedVia(const Int_t netIdx, const Int_t x, const Int_t y, const LefVia& via) {
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   bool ret = true;
   for (auto box : via.vBotBoxes()) {
     box.shift(x, y);
-    ret &= _vSpatialRoutedWires[via.botLayerIdx()].erase(box, netIdx);
+    ret &= _spatialRoutedWires.erase(via.botLayerIdx(), box, netIdx);
   }
   for (auto box : via.vCutBoxes()) {
     box.shift(x, y);
-    ret &= _vSpatialRoutedWires[via.cutLayerIdx()].erase(box, netIdx);
+    ret &= _spatialRoutedWires.erase(via.cutLayerIdx(), box, netIdx);
   }
   for (auto box : via.vTopBoxes()) {
     box.shift(x, y);
-    ret &= _vSpatialRoutedWires[via.topLayerIdx()].erase(box, netIdx);
+    ret &= _spatialRoutedWires.erase(via.topLayerIdx(), box, netIdx);
   }
   return ret;
 }
@@ -231,29 +305,30 @@ bool CirDB::querySpatialBlk(const UInt_t layerIdx, const Box<Int_t>& box, Vector
 }
 
 bool CirDB::existSpatialPin(const UInt_t layerIdx, const Point<Int_t>& bl, const Point<Int_t>& tr) {
-  Vector_t<UInt_t> vTmp;
-  return querySpatialPin(layerIdx, bl, tr, vTmp);
+  assert(layerIdx >= 0 and layerIdx < _vSpatialPins.size());
+  return _vSpatialPins[layerIdx].exist(bl, tr);
 }
 
 bool CirDB::existSpatialPin(const UInt_t layerIdx, const Box<Int_t>& box) {
-  Vector_t<UInt_t> vTmp;
-  return querySpatialPin(layerIdx, box, vTmp);
+  assert(layerIdx >= 0 and layerIdx < _vSpatialPins.size());
+  return _vSpatialPins[layerIdx].exist(box);
 }
 
 bool CirDB::existSpatialBlk(const UInt_t layerIdx, const Point<Int_t>& bl, const Point<Int_t>& tr) {
-  Vector_t<UInt_t> vTmp;
-  return querySpatialBlk(layerIdx, bl, tr, vTmp);
+  assert(layerIdx >= 0 and layerIdx < _vSpatialBlks.size());
+  return _vSpatialBlks[layerIdx].exist(bl, tr);
 }
 
 bool CirDB::existSpatialBlk(const UInt_t layerIdx, const Box<Int_t>& box) {
-  Vector_t<UInt_t> vTmp;
-  return querySpatialBlk(layerIdx, box, vTmp);
+  assert(layerIdx >= 0 and layerIdx < _vSpatialBlks.size());
+  return _vSpatialBlks[layerIdx].exist(box);
 }
 
 bool CirDB::querySpatialRoutedWire(const UInt_t layerIdx, const Point<Int_t>& bl, const Point<Int_t>& tr, Vector_t<UInt_t>& vNetIndices, Vector_t<Box<Int_t>>& vWires) {
+  std::shared_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   assert(layerIdx >= 0 and layerIdx < _vSpatialPins.size());
   Vector_t<Pair_t<Box<Int_t>, UInt_t>> vRet;
-  _vSpatialRoutedWires[layerIdx].queryBoth(bl, tr, vRet);
+  _spatialRoutedWires.layer(layerIdx).queryBoth(bl, tr, vRet);
   vNetIndices.reserve(vRet.size());
   vWires.reserve(vRet.size());
   for (const auto& pair : vRet) {
@@ -264,9 +339,10 @@ bool CirDB::querySpatialRoutedWire(const UInt_t layerIdx, const Point<Int_t>& bl
 }
 
 bool CirDB::querySpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box, Vector_t<UInt_t>& vNetIndices, Vector_t<Box<Int_t>>& vWires) {
+  std::shared_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
   assert(layerIdx >= 0 and layerIdx < _vSpatialPins.size());
   Vector_t<Pair_t<Box<Int_t>, UInt_t>> vRet;
-  _vSpatialRoutedWires[layerIdx].queryBoth(box, vRet);
+  _spatialRoutedWires.layer(layerIdx).queryBoth(box, vRet);
   vNetIndices.reserve(vRet.size());
   vWires.reserve(vRet.size());
   for (const auto& pair : vRet) {
@@ -277,33 +353,38 @@ bool CirDB::querySpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box,
 }
 
 bool CirDB::existSpatialRoutedWire(const UInt_t layerIdx, const Point<Int_t>& bl,const Point<Int_t>& tr) {
-  return _vSpatialRoutedWires[layerIdx].exist(bl, tr);
+  std::shared_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  return _spatialRoutedWires.layer(layerIdx).exist(bl, tr);
 }
 
 bool CirDB::existSpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box) {
-  return _vSpatialRoutedWires[layerIdx].exist(box);
+  std::shared_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  return _spatialRoutedWires.layer(layerIdx).exist(box);
 }
 
 bool CirDB::existSpatialRoutedWireNet(const UInt_t layerIdx, const Point<Int_t>& bl, const Point<Int_t>& tr, const UInt_t netIdx) {
-  Vector_t<UInt_t> vNetIndices;
-  Vector_t<Box<Int_t>> vWires;
-  querySpatialRoutedWire(layerIdx, bl, tr, vNetIndices, vWires);
-  for (const UInt_t idx : vNetIndices) {
-    if (idx == netIdx)
-      return true;
-  }
-  return false;
+  return existSpatialRoutedWireNet(layerIdx, Box<Int_t>(bl, tr), netIdx);
 }
 
 bool CirDB::existSpatialRoutedWireNet(const UInt_t layerIdx, const Box<Int_t>& box, const UInt_t netIdx) {
-  Vector_t<UInt_t> vNetIndices;
-  Vector_t<Box<Int_t>> vWires;
-  querySpatialRoutedWire(layerIdx, box, vNetIndices, vWires);
-  for (const UInt_t idx : vNetIndices) {
-    if (idx == netIdx)
-      return true;
+  return existSpatialRoutedWire(layerIdx, box, [netIdx] (const Box<Int_t>& wire, const UInt_t idx) {
+    return idx == netIdx;
+  });
+}
+
+void CirDB::buildViaCatalog(const Vector_t<Pair_t<UInt_t, UInt_t>>& vNumCuts) {
+  Vector_t<Int_t> vWireWidths;
+  for (const Net& net : _vNets) {
+    vWireWidths.emplace_back(net.minWidth());
   }
-  return false;
+  _lef.buildViaCatalog(vWireWidths, vNumCuts);
+}
+
+void CirDB::copyRoutingState(const CirDB& c) {
+  assert(c._vNets.size() == _vNets.size());
+  _vNets = c._vNets;
+  std::unique_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  _spatialRoutedWires = c._spatialRoutedWires;
 }
 
 void CirDB::markBlks() {
@@ -314,18 +395,15 @@ void CirDB::markBlks() {
     Pin_ForEachLayerIdx((*pPin), layerIdx) {
       Pin_ForEachLayerBox((*pPin), layerIdx, pBox, j) {
         const Box<Int_t>& box = *pBox;
-        Vector_t<UInt_t> vBlkIndices;
-        querySpatialBlk(layerIdx, box, vBlkIndices);
-        for (const UInt_t idx : vBlkIndices) {
+        _vSpatialBlks[layerIdx].visit(box, [&] (const Box<Int_t>& blkBox, const UInt_t idx) {
           Blk& blk = _vBlks[idx];
-          const Box<Int_t>& blkBox = blk.box();
           if (Box<Int_t>::bCover(box, blkBox)) {
               //or Box<Int_t>::bCover(blkBox, box)) {
             blk.setDummy();
             //std::cerr << blkBox << std::endl;
           }
           blk.setPinIdx(pPin->idx());
-        }
+        });
       }
     }
   }
@@ -334,12 +412,10 @@ void CirDB::markBlks() {
 Int_t CirDB::overlapAreaWithOD(const Box<Int_t> &box) const
 {
     Int_t area = 0;
-    Vector_t<Box<Int_t>> rects; 
-    _spatialOD.query(box, rects);
-    for (const auto &rect : rects)
+    _spatialOD.visit(box, [&] (const Box<Int_t> &rect)
     {
         area += Box<Int_t>::overlapArea(box, rect);
-    }
+    });
     return area;
 }
 
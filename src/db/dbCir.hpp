@@ -16,8 +16,13 @@
 #include "dbPin.hpp"
 #include "dbNet.hpp"
 #include "routeGuide.hpp"
+#include "netGuideMap.hpp"
+#include "dbRoutedWireStore.hpp"
 #include "src/geo/spatial.hpp"
 
+#include <mutex>
+#include <shared_mutex>
+
 PROJECT_NAMESPACE_START
 
 class CirDB {
@@ -30,7 +35,7 @@ class CirDB {
 
  public:
   CirDB()
-    : _name(""), _xl(0), _yl(0), _xh(0), _yh(0) {}
+    : _name(""), _xl(0), _yl(0), _xh(0), _yh(0), _bRoutedWireBinGrid(false) {}
   ~CirDB() {}
   //////////////////////////////////
   //  Getter                      //
@@ -151,13 +156,22 @@ class CirDB {
   // Spatial
   const Vector_t<SpatialMap<Int_t, UInt_t>>& vSpatialPins()        const { return _vSpatialPins; }
   const Vector_t<SpatialMap<Int_t, UInt_t>>& vSpatialBlks()        const { return _vSpatialBlks; }
-  const Vector_t<SpatialMap<Int_t, UInt_t>>& vSpatialRoutedWires() const { return _vSpatialRoutedWires; }
+  const RoutedWireStore&                     spatialRoutedWires()  const { return _spatialRoutedWires; }
   const Vector_t<Spatial<Int_t>>&            vSpatialNetGuides(const UInt_t netIdx) const { return _vvSpatialNetGuides[netIdx]; }
+  bool bInsideNetGuide(const UInt_t netIdx, const Int_t layerIdx, const Int_t x, const Int_t y) const { return _vNetGuideMaps[netIdx].bInside(layerIdx, x, y); }
   void buildSpatial();
   void buildSpatialPins();
   void buildSpatialBlks();
   void buildSpatialNetGuides();
+  void buildSpatialOD();
   void initSpatialRoutedWires();
+  // index the routed wires with bin grids instead of R-trees, set before buildSpatial
+  void setRoutedWireBinGrid(const bool b) { _bRoutedWireBinGrid = b; }
+  // the routed wires and cover raster as of the last publishRoutedWires(), for readers running beside a writer
+  RoutedWireStore::SnapshotPtr routedWireSnapshot() const { return _spatialRoutedWires.snapshot(); }
+  // make all routed wire changes so far visible to new snapshots at once
+  void publishRoutedWires();
+  void buildCoverRaster();
   void addSpatialOD(const Box<Int_t>& box);
   void addSpatialRoutedWire(const UInt_t netIdx, const Point3d<Int_t>& u, const Point3d<Int_t>& v);
   void addSpatialRoutedWire(const UInt_t netIdx, const UInt_t layerIdx, const Box<Int_t>& box);
@@ -181,11 +195,29 @@ class CirDB {
   bool existSpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box);
   bool existSpatialRoutedWireNet(const UInt_t layerIdx, const Point<Int_t>& bl, const Point<Int_t>& tr, const UInt_t netIdx);
   bool existSpatialRoutedWireNet(const UInt_t layerIdx, const Box<Int_t>& box, const UInt_t netIdx);
+  // allocation-free: pred(const Box<Int_t>&, const UInt_t idx) selects the hits,
+  // visitor(const Box<Int_t>&, const UInt_t netIdx) is called on every routed wire touching box
+  template<typename Pred>
+  bool existSpatialPin(const UInt_t layerIdx, const Box<Int_t>& box, Pred pred) const;
+  template<typename Pred>
+  bool existSpatialBlk(const UInt_t layerIdx, const Box<Int_t>& box, Pred pred) const;
+  template<typename Pred>
+  bool existSpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box, Pred pred) const;
+  template<typename Visitor>
+  void visitSpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box, Visitor visitor) const;
+  // true: no pin, blk or routed shape of any net within the layer spacing of box
+  bool bCoverRasterClean(const UInt_t layerIdx, const Box<Int_t>& box) const;
   /// @brief compute the overlapping area with OD shapes
   /// @param a box
   /// @return the area this box overlapped with OD shapes
   Int_t overlapAreaWithOD(const Box<Int_t> &box) const;
  
+  // configure the lef vias of the given (row, col) cut arrays for the net wire widths
+  void buildViaCatalog(const Vector_t<Pair_t<UInt_t, UInt_t>>& vNumCuts);
+
+  // take over the nets and routed wires of another copy of this circuit
+  void copyRoutingState(const CirDB& c);
+
   // fix
   void markBlks();
   void addBlk2ConnectedPin();
@@ -251,10 +283,21 @@ class CirDB {
  
   Vector_t<SpatialMap<Int_t, UInt_t>>  _vSpatialPins;
   Vector_t<SpatialMap<Int_t, UInt_t>>  _vSpatialBlks;
-  Vector_t<SpatialMap<Int_t, UInt_t>>  _vSpatialRoutedWires;
+  RoutedWireStore                      _spatialRoutedWires;
+  bool                                 _bRoutedWireBinGrid;
+  // a copy of the database gets a fresh lock
+  struct RoutedWireMutex {
+    RoutedWireMutex() {}
+    RoutedWireMutex(const RoutedWireMutex&) {}
+    RoutedWireMutex& operator = (const RoutedWireMutex&) { return *this; }
+    std::shared_timed_mutex m;
+  };
+  mutable RoutedWireMutex              _routedWireMutex; ///< guards the live _spatialRoutedWires during parallel routing
   Spatial<Int_t> _spatialOD; ///< The spatial representation of OD layers
+  Vector_t<spatial::b_box<Int_t>>      _vODShapes; ///< OD shapes from the parser, packed into _spatialOD
 
   Vector_t<Vector_t<Spatial<Int_t>>>   _vvSpatialNetGuides;
+  Vector_t<NetGuideMap>                _vNetGuideMaps; ///< _vvSpatialNetGuides on the routing grid
 
   Vector_t<Vector_t<Box<Int_t>>> _vvMaskWires; // for convex jogs, to remove from layout
   Vector_t<Vector_t<Box<Int_t>>> _vvPatchWires; // for concave jogs, to add to layout
@@ -266,6 +309,35 @@ class CirDB {
   //////////////////////////////////
 };
 
+////////////////////////////////////////
+//   Spatial templates                //
+////////////////////////////////////////
+template<typename Pred>
+bool CirDB::existSpatialPin(const UInt_t layerIdx, const Box<Int_t>& box, Pred pred) const {
+  assert(layerIdx >= 0 and layerIdx < _vSpatialPins.size());
+  return _vSpatialPins[layerIdx].exist(box, pred);
+}
+
+template<typename Pred>
+bool CirDB::existSpatialBlk(const UInt_t layerIdx, const Box<Int_t>& box, Pred pred) const {
+  assert(layerIdx >= 0 and layerIdx < _vSpatialBlks.size());
+  return _vSpatialBlks[layerIdx].exist(box, pred);
+}
+
+template<typename Pred>
+bool CirDB::existSpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box, Pred pred) const {
+  std::shared_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  assert(layerIdx >= 0 and layerIdx < _spatialRoutedWires.numLayers());
+  return _spatialRoutedWires.layer(layerIdx).exist(box, pred);
+}
+
+template<typename Visitor>
+void CirDB::visitSpatialRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box, Visitor visitor) const {
+  std::shared_lock<std::shared_timed_mutex> lock(_routedWireMutex.m);
+  assert(layerIdx >= 0 and layerIdx < _spatialRoutedWires.numLayers());
+  _spatialRoutedWires.layer(layerIdx).visit(box, visitor);
+}
+
 ////////////////////////////////////////
 //   Iterators                        //
 ////////////////////////////////////////
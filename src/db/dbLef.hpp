@@ -116,29 +116,20 @@ class LefDB {
   void constructViaTableFromViaRule() {
     _viaTable = LefViaTable(_vRoutingLayers.size() + _vMastersliceLayers.size());
     _viaTable.generateVias(*this);
+    _viaCatalog.build(_viaTable, Vector_t<Int_t>(), Vector_t<Pair_t<UInt_t, UInt_t>>());
   }
-  // lowerLayerIdx: M1 -> 2
-  LefVia         via(const Int_t botLayerIdx, const Int_t row, const Int_t col)
-  {
-    auto metalIdx = layerPair(botLayerIdx).second;
-    auto &prototype = _viaTable.viaProtoType(metalIdx, row, col);
-    prototype.configureDefault();
-    return prototype.lefVia();
+  // precompute the via shapes of the given (row, col) cut arrays for the given wire widths
+  void buildViaCatalog(const Vector_t<Int_t>& vWireWidths, const Vector_t<Pair_t<UInt_t, UInt_t>>& vNumCuts) {
+    _viaCatalog.build(_viaTable, vWireWidths, vNumCuts);
   }
-  LefVia         via(const Int_t botLayerIdx, const Int_t row, const Int_t col, Orient2D_t bot, Orient2D_t top)
+  // lowerLayerIdx: M1 -> 2
+  const LefVia&  via(const Int_t botLayerIdx, const Int_t row, const Int_t col) const
   {
-    auto metalIdx = layerPair(botLayerIdx).second;
-    auto &prototype = _viaTable.viaProtoType(metalIdx, row, col);
-    prototype.configureMetalWithHeightWithDirection(bot, top);
-    return prototype.lefVia();
+    return _viaCatalog.via(layerPair(botLayerIdx).second, row, col);
   }
-
-  LefVia via(const Int_t botLayerIdx, const Int_t row, const Int_t col, Int_t botWidth, Int_t botHeight, Int_t topWidth, Int_t topHeight)
+  const LefVia&  via(const Int_t botLayerIdx, const Int_t row, const Int_t col, Int_t botWidth, Int_t botHeight, Int_t topWidth, Int_t topHeight) const
   {
-    auto metalIdx = layerPair(botLayerIdx).second;
-    auto &prototype = _viaTable.viaProtoType(metalIdx, row, col);
-    prototype.configureMetalWidthHeight(botWidth, botHeight, topWidth, topHeight);
-    return prototype.lefVia();
+    return _viaCatalog.via(layerPair(botLayerIdx).second, row, col, botWidth, botHeight, topWidth, topHeight);
   }
 
   ////////////////////////////////////////
@@ -188,7 +179,8 @@ class LefDB {
   Vector_t<LefVia>              _vVias;
   Vector_t<Vector_t<UInt_t>>    _vvViaIndices;
   UMap_t<String_t, UInt_t>      _mStr2ViaIdx;
-  LefViaTable _viaTable;
+  LefViaTable   _viaTable;
+  LefViaCatalog _viaCatalog;
 
   // Viarule
   Vector_t<LefViaRuleTemplate1> _vViaRuleTemplate1; ///< ViaRule template 1.  No special Via property. enclosure and width in metals. rect and spacing in via Based on tsmc40 lef.
@@ -219,7 +219,7 @@ class Net {
 
   // for performance driven and electrical consideration
   bool    _bPower = false;
-  Int_t   _minWidth;
+  Int_t   _minWidth = 0;
   Int_t   _minCuts;
   Int_t   _numCutsRow;
   Int_t   _numCutsCol;
@@ -0,0 +1,96 @@
+/**
+ * @file   dbRoutedWireMap.hpp
+ * @brief  Circuit Element - Spatial index of the routed wires in one layer
+ *
+ **/
+
+#ifndef _DB_ROUTED_WIRE_MAP_HPP_
+#define _DB_ROUTED_WIRE_MAP_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/spatial.hpp"
+#include "src/geo/binGrid.hpp"
+
+PROJECT_NAMESPACE_START
+
+// Routed wire boxes with their net indices, kept in either an R-tree or a
+// uniform bin grid. The R-tree is the default; the bin grid suits the many
+// small grid-aligned wires that rip-up keeps inserting and erasing.
+// Both answer the same intersects queries.
+class RoutedWireMap {
+ public:
+  RoutedWireMap()
+    : _bBinGrid(false) {}
+  ~RoutedWireMap() {}
+
+  void initRtree() {
+    _bBinGrid = false;
+    _rtree.clear();
+    _binGrid = BinGridMap<Int_t, UInt_t>();
+  }
+  void initBinGrid(const Box<Int_t>& bound, const Int_t binSize) {
+    _bBinGrid = true;
+    _rtree.clear();
+    _binGrid.init(bound, binSize);
+  }
+
+  // get
+  bool    bBinGrid() const { return _bBinGrid; }
+  bool    empty()    const { return _bBinGrid ? _binGrid.empty() : _rtree.empty(); }
+  size_t  size()     const { return _bBinGrid ? _binGrid.size() : _rtree.size(); }
+
+  // set
+  void clear() {
+    _rtree.clear();
+    _binGrid.clear();
+  }
+  void insert(const Box<Int_t>& box, const UInt_t netIdx) {
+    if (_bBinGrid)
+      _binGrid.insert(box, netIdx);
+    else
+      _rtree.insert(box, netIdx);
+  }
+  bool erase(const Box<Int_t>& box, const UInt_t netIdx) {
+    return _bBinGrid ? _binGrid.erase(box, netIdx) : _rtree.erase(box, netIdx);
+  }
+
+  // query, visitor(const Box<Int_t>&, const UInt_t netIdx) and pred alike
+  template<typename Visitor>
+  void visit(const Box<Int_t>& box, Visitor visitor) const {
+    if (_bBinGrid)
+      _binGrid.visit(box, visitor);
+    else
+      _rtree.visit(box, visitor);
+  }
+  template<typename Pred>
+  bool exist(const Box<Int_t>& box, Pred pred) const {
+    return _bBinGrid ? _binGrid.exist(box, pred) : _rtree.exist(box, pred);
+  }
+  bool exist(const Box<Int_t>& box) const {
+    return _bBinGrid ? _binGrid.exist(box) : _rtree.exist(box);
+  }
+  bool exist(const Point<Int_t>& bl, const Point<Int_t>& tr) const {
+    return exist(Box<Int_t>(bl, tr));
+  }
+  size_t count(const Box<Int_t>& box) const {
+    return _bBinGrid ? _binGrid.count(box) : _rtree.count(box);
+  }
+  void queryBoth(const Box<Int_t>& box, Vector_t<Pair_t<Box<Int_t>, UInt_t>>& ret) const {
+    if (_bBinGrid)
+      _binGrid.queryBoth(box, ret);
+    else
+      _rtree.queryBoth(box, ret);
+  }
+  void queryBoth(const Point<Int_t>& bl, const Point<Int_t>& tr, Vector_t<Pair_t<Box<Int_t>, UInt_t>>& ret) const {
+    queryBoth(Box<Int_t>(bl, tr), ret);
+  }
+
+ private:
+  bool                          _bBinGrid;
+  SpatialMap<Int_t, UInt_t>     _rtree;
+  BinGridMap<Int_t, UInt_t>     _binGrid;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _DB_ROUTED_WIRE_MAP_HPP_
@@ -0,0 +1,235 @@
+/**
+ * @file   dbRoutedWireStore.hpp
+ * @brief  Circuit Element - Routed shapes of all layers with published read snapshots
+ *
+ **/
+
+#ifndef _DB_ROUTED_WIRE_STORE_HPP_
+#define _DB_ROUTED_WIRE_STORE_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/coverRaster.hpp"
+#include "src/geo/cowGrid.hpp"
+#include "dbRoutedWireMap.hpp"
+
+#include <memory>
+
+PROJECT_NAMESPACE_START
+
+// The routed wires of one layer in square copy-on-write tiles, each tile a
+// RoutedWireMap of the wires touching it. A wire is kept in every tile it
+// touches and a query reports it from the tile holding the lower-left
+// corner of the intersection only, like BinGridMap.
+// Copying a layer shares all tiles; a write copies only the tiles it touches.
+class RoutedWireLayer {
+ public:
+  RoutedWireLayer()
+    : _xl(0), _yl(0), _tileSize(1), _size(0) {}
+  ~RoutedWireLayer() {}
+
+  // tiles index with R-trees, or bin grids of binSize if binSize > 0
+  void init(const Box<Int_t>& bound, const Int_t tileSize, const Int_t binSize) {
+    assert(tileSize > 0);
+    _xl = bound.xl();
+    _yl = bound.yl();
+    _tileSize = tileSize;
+    _size = 0;
+    _grid.init(bound.width() / tileSize + 1, bound.height() / tileSize + 1, [&] (const Int_t x, const Int_t y) {
+      RoutedWireMap map;
+      if (binSize > 0)
+        map.initBinGrid(Box<Int_t>(_xl + x * tileSize, _yl + y * tileSize, _xl + (x + 1) * tileSize, _yl + (y + 1) * tileSize), binSize);
+      else
+        map.initRtree();
+      return map;
+    });
+  }
+
+  // get
+  bool    empty() const { return _size == 0; }
+  size_t  size()  const { return _size; }
+
+  // set
+  void insert(const Box<Int_t>& box, const UInt_t netIdx) {
+    for (Int_t y = tileY(box.yl()); y <= tileY(box.yh()); ++y) {
+      for (Int_t x = tileX(box.xl()); x <= tileX(box.xh()); ++x) {
+        _grid.writableTile(x, y).insert(box, netIdx);
+      }
+    }
+    ++_size;
+  }
+  bool erase(const Box<Int_t>& box, const UInt_t netIdx) {
+    // do not copy shared tiles for nothing
+    if (!_grid.tile(tileX(box.xl()), tileY(box.yl())).exist(box, [&] (const Box<Int_t>& b, const UInt_t idx) {
+          return idx == netIdx and b == box;
+        }))
+      return false;
+    for (Int_t y = tileY(box.yl()); y <= tileY(box.yh()); ++y) {
+      for (Int_t x = tileX(box.xl()); x <= tileX(box.xh()); ++x) {
+        _grid.writableTile(x, y).erase(box, netIdx);
+      }
+    }
+    --_size;
+    return true;
+  }
+
+  // query, visitor(const Box<Int_t>&, const UInt_t netIdx) and pred alike
+  template<typename Visitor>
+  void visit(const Box<Int_t>& box, Visitor visitor) const {
+    forEach(box, [&] (const Box<Int_t>& b, const UInt_t idx) { visitor(b, idx); return false; });
+  }
+  template<typename Pred>
+  bool exist(const Box<Int_t>& box, Pred pred) const {
+    return forEach(box, pred);
+  }
+  bool exist(const Box<Int_t>& box) const {
+    return forEach(box, [] (const Box<Int_t>& b, const UInt_t idx) { return true; });
+  }
+  bool exist(const Point<Int_t>& bl, const Point<Int_t>& tr) const {
+    return exist(Box<Int_t>(bl, tr));
+  }
+  size_t count(const Box<Int_t>& box) const {
+    size_t cnt = 0;
+    forEach(box, [&] (const Box<Int_t>& b, const UInt_t idx) { ++cnt; return false; });
+    return cnt;
+  }
+  void queryBoth(const Box<Int_t>& box, Vector_t<Pair_t<Box<Int_t>, UInt_t>>& ret) const {
+    forEach(box, [&] (const Box<Int_t>& b, const UInt_t idx) { ret.emplace_back(b, idx); return false; });
+  }
+  void queryBoth(const Point<Int_t>& bl, const Point<Int_t>& tr, Vector_t<Pair_t<Box<Int_t>, UInt_t>>& ret) const {
+    queryBoth(Box<Int_t>(bl, tr), ret);
+  }
+
+ private:
+  Int_t                   _xl;
+  Int_t                   _yl;
+  Int_t                   _tileSize;
+  size_t                  _size;
+  CowGrid<RoutedWireMap>  _grid;
+
+  Int_t tileX(const Int_t x) const {
+    return std::min(std::max((x - _xl) / _tileSize, 0), _grid.numTilesX() - 1);
+  }
+  Int_t tileY(const Int_t y) const {
+    return std::min(std::max((y - _yl) / _tileSize, 0), _grid.numTilesY() - 1);
+  }
+
+  // run f on every wire touching box until it returns true
+  template<typename F>
+  bool forEach(const Box<Int_t>& box, F f) const {
+    if (!_grid.bInit())
+      return false;
+    const Int_t xl = tileX(box.xl()), xh = tileX(box.xh());
+    const Int_t yl = tileY(box.yl()), yh = tileY(box.yh());
+    // most checks stay inside one tile, nothing to filter then
+    if (xl == xh and yl == yh)
+      return _grid.tile(xl, yl).exist(box, [&] (const Box<Int_t>& b, const UInt_t idx) { return (bool)f(b, idx); });
+    for (Int_t y = yl; y <= yh; ++y) {
+      for (Int_t x = xl; x <= xh; ++x) {
+        const bool bFound = _grid.tile(x, y).exist(box, [&] (const Box<Int_t>& b, const UInt_t idx) {
+          // report from the tile of the lower-left corner of the intersection only
+          if (tileX(std::max(b.xl(), box.xl())) != x or tileY(std::max(b.yl(), box.yl())) != y)
+            return false;
+          return (bool)f(b, idx);
+        });
+        if (bFound)
+          return true;
+      }
+    }
+    return false;
+  }
+};
+
+// The live routed wires and cover raster, changed in place by a single
+// writer (the caller serializes writers and the readers of the live state),
+// plus the immutable snapshot of the last publish().
+// A snapshot is a copy of the live layers and raster, which shares their
+// tiles; the writer copies a tile the first time it changes it after a
+// publish, so a commit copies the tiles it touches and nothing else.
+// Taking a snapshot is an atomic pointer load; readers never wait for the
+// writer, and a snapshot stays valid (and its tiles alive) as long as it is
+// held. Publishing once per committed net means a reader sees either all
+// the wires of a net or none of them.
+class RoutedWireStore {
+ public:
+  class Snapshot {
+   public:
+    UInt_t                  epoch()                          const { return _epoch; }
+    UInt_t                  numLayers()                      const { return _vLayers.size(); }
+    const RoutedWireLayer&  layer(const UInt_t layerIdx)     const { return _vLayers[layerIdx]; }
+    const CoverRaster&      coverRaster()                    const { return _coverRaster; }
+
+   private:
+    friend class RoutedWireStore;
+    UInt_t                    _epoch = 0; // publishes so far
+    Vector_t<RoutedWireLayer> _vLayers;
+    CoverRaster               _coverRaster;
+  };
+  typedef std::shared_ptr<const Snapshot> SnapshotPtr;
+
+  RoutedWireStore()
+    : _epoch(0), _pSnapshot(std::make_shared<Snapshot>()) {}
+  // a copy shares the tiles, either side copies a tile before changing it
+  RoutedWireStore(const RoutedWireStore& s)
+    : _epoch(0) { *this = s; }
+  RoutedWireStore& operator = (const RoutedWireStore& s) {
+    _vLayers = s._vLayers;
+    _coverRaster = s._coverRaster;
+    _epoch = s._epoch;
+    publish();
+    return *this;
+  }
+  ~RoutedWireStore() {}
+
+  // tiles of tileSize, indexed with R-trees, or bin grids of binSize if binSize > 0
+  void init(const UInt_t numLayers, const Box<Int_t>& bound, const Int_t tileSize, const Int_t binSize) {
+    _vLayers.assign(numLayers, RoutedWireLayer());
+    for (RoutedWireLayer& layer : _vLayers) {
+      layer.init(bound, tileSize, binSize);
+    }
+    _epoch = 0;
+    publish();
+  }
+
+  ////////// writer //////////
+  UInt_t                  numLayers()                      const { return _vLayers.size(); }
+  // live state, the caller excludes the writer
+  const RoutedWireLayer&  layer(const UInt_t layerIdx)     const { return _vLayers[layerIdx]; }
+  const CoverRaster&      coverRaster()                    const { return _coverRaster; }
+  // pins and blks go to the raster only
+  CoverRaster&            coverRaster()                          { return _coverRaster; }
+
+  // the wire is added to the cover raster too
+  void insert(const UInt_t layerIdx, const Box<Int_t>& box, const UInt_t netIdx) {
+    _vLayers[layerIdx].insert(box, netIdx);
+    _coverRaster.insert(layerIdx, box);
+  }
+  bool erase(const UInt_t layerIdx, const Box<Int_t>& box, const UInt_t netIdx) {
+    if (!_vLayers[layerIdx].erase(box, netIdx))
+      return false;
+    _coverRaster.erase(layerIdx, box);
+    return true;
+  }
+
+  // make the live state the current snapshot
+  void publish() {
+    std::shared_ptr<Snapshot> pSnapshot = std::make_shared<Snapshot>();
+    pSnapshot->_epoch = ++_epoch;
+    pSnapshot->_vLayers = _vLayers;
+    pSnapshot->_coverRaster = _coverRaster;
+    std::atomic_store(&_pSnapshot, SnapshotPtr(std::move(pSnapshot)));
+  }
+
+  ////////// reader //////////
+  // the state of the last publish(), safe to use from any thread
+  SnapshotPtr snapshot() const { return std::atomic_load(&_pSnapshot); }
+
+ private:
+  Vector_t<RoutedWireLayer> _vLayers;
+  CoverRaster               _coverRaster; // pins, blks and routed wires
+  UInt_t                    _epoch;
+  SnapshotPtr               _pSnapshot;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _DB_ROUTED_WIRE_STORE_HPP_
@@ -295,5 +295,102 @@ void LefViaTable::generateVias(LefDB &lef)
     }
 }
 
+void LefViaCatalog::build(LefViaTable &table, const Vector_t<Int_t> &vWireWidths, const Vector_t<Pair_t<UInt_t, UInt_t>> &vNumCuts)
+{
+    _vWireWidths.clear();
+    for (const Int_t width : vWireWidths)
+    {
+        if (width > 0)
+        {
+            _vWireWidths.emplace_back(width);
+        }
+    }
+    std::sort(_vWireWidths.begin(), _vWireWidths.end());
+    _vWireWidths.erase(std::unique(_vWireWidths.begin(), _vWireWidths.end()), _vWireWidths.end());
+
+    const UInt_t numLayers = table._table.size();
+    const UInt_t numRows = LefViaTable::MAX_GENERATE_ROW - LefViaTable::MIN_GENERATE_ROW + 1;
+    const UInt_t numCols = LefViaTable::MAX_GENERATE_COLUMN - LefViaTable::MIN_GENERATE_COLUMN + 1;
+    Vector2D<Byte_t> vbBuild(numRows, numCols, false);
+    for (const auto &numCuts : vNumCuts)
+    {
+        vbBuild.at(numCuts.first - LefViaTable::MIN_GENERATE_ROW, numCuts.second - LefViaTable::MIN_GENERATE_COLUMN) = true;
+    }
+    _vDefaultVias.assign(numLayers, Vector2D<LefVia>(numRows, numCols));
+    _vClassBegins.assign(numLayers * numRows * numCols, Int_t(FIXED_VIA));
+    _vVias.clear();
+    for (UInt_t layer = 0; layer < numLayers; ++layer)
+    {
+        for (UInt_t row = LefViaTable::MIN_GENERATE_ROW; row <= LefViaTable::MAX_GENERATE_ROW; ++row)
+        {
+            for (UInt_t col = LefViaTable::MIN_GENERATE_COLUMN; col <= LefViaTable::MAX_GENERATE_COLUMN; ++col)
+            {
+                auto &prototype = table.viaProtoType(layer, row, col);
+                if (!prototype.bConfigurable())
+                {
+                    _vDefaultVias.at(layer).at(row - LefViaTable::MIN_GENERATE_ROW, col - LefViaTable::MIN_GENERATE_COLUMN) = prototype.lefVia();
+                    continue;
+                }
+                prototype.configureDefault();
+                _vDefaultVias.at(layer).at(row - LefViaTable::MIN_GENERATE_ROW, col - LefViaTable::MIN_GENERATE_COLUMN) = prototype.lefVia();
+                if (!vbBuild.at(row - LefViaTable::MIN_GENERATE_ROW, col - LefViaTable::MIN_GENERATE_COLUMN))
+                {
+                    _vClassBegins.at(protoIdx(layer, row, col)) = NO_VIA;
+                    continue;
+                }
+                _vClassBegins.at(protoIdx(layer, row, col)) = _vVias.size();
+                for (UInt_t botClass = 0; botClass < numClasses(); ++botClass)
+                {
+                    for (UInt_t topClass = 0; topClass < numClasses(); ++topClass)
+                    {
+                        Int_t botWidth, botHeight, topWidth, topHeight;
+                        classWidthHeight(botClass, botWidth, botHeight);
+                        classWidthHeight(topClass, topWidth, topHeight);
+                        // an infeasible configuration keeps the default shapes
+                        prototype.configureDefault();
+                        prototype.configureMetalWidthHeight(botWidth, botHeight, topWidth, topHeight);
+                        _vVias.emplace_back(prototype.lefVia());
+                    }
+                }
+                prototype.configureDefault();
+            }
+        }
+    }
+}
+
+UInt_t LefViaCatalog::sideClass(Int_t width, Int_t height) const
+{
+    if (width <= 0 and height <= 0)
+    {
+        return 0;
+    }
+    assert(width <= 0 or height <= 0 or width == height);
+    const Int_t target = width > 0 ? width : height;
+    const auto it = std::lower_bound(_vWireWidths.begin(), _vWireWidths.end(), target);
+    assert(it != _vWireWidths.end() and *it == target);
+    const UInt_t shape = (width > 0 and height > 0) ? 2 : (width > 0 ? 0 : 1);
+    return 1 + 3 * (it - _vWireWidths.begin()) + shape;
+}
+
+void LefViaCatalog::classWidthHeight(UInt_t c, Int_t &width, Int_t &height) const
+{
+    width = -1;
+    height = -1;
+    if (c == 0)
+    {
+        return;
+    }
+    const Int_t target = _vWireWidths.at((c - 1) / 3);
+    const UInt_t shape = (c - 1) % 3;
+    if (shape == 0 or shape == 2)
+    {
+        width = target;
+    }
+    if (shape == 1 or shape == 2)
+    {
+        height = target;
+    }
+}
+
 PROJECT_NAMESPACE_END
 
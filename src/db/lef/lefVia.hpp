@@ -165,6 +165,8 @@ class LefViaPrototype
     {
       _implementor->configureDefault();
     }
+    /// @brief whether the prototype has been generated from a viarule
+    bool bConfigurable() const { return _implementor != nullptr; }
   protected:
     LefVia _lefVia;
     std::shared_ptr<LefViaImplementor> _implementor = nullptr;
@@ -173,6 +175,7 @@ class LefViaPrototype
 /// @brief the table for LefVia
 class LefViaTable
 {
+    friend class LefViaCatalog;
     protected:
         static constexpr UInt_t MAX_GENERATE_ROW = 4; ///< The max number of rows to generate
         static constexpr UInt_t MIN_GENERATE_ROW = 1; ///< The min number of rows to generate
@@ -211,6 +214,63 @@ class LefViaTable
         Vector_t<Vector2D<LefViaPrototype>> _table; ///< _table[layer][# of rows][# of columns] = via
 };
 
+/// @brief the read-only catalog of configured vias
+/// Every via of a LefViaTable is kept once in default mode. The configurable ones are
+/// also configured once per (bottom class, top class) for the (row, col) cut arrays
+/// given to build(), so that looking up a via neither copies it nor reconfigures the
+/// shared prototypes. The others have no shapes to fit and serve every class as is.
+/// The width-height class of a via metal is one of: don't care, constrained width,
+/// constrained height, or both, for each of the wire widths given to build().
+class LefViaCatalog
+{
+    public:
+        LefViaCatalog() = default;
+        /// @brief configure the vias of the table
+        /// @param first: the via table. The prototypes are left in default mode
+        /// @param second: the wire widths the vias may connect to
+        /// @param third: the (row, col) cut arrays to fit to the wire widths
+        void build(LefViaTable &table, const Vector_t<Int_t> &vWireWidths, const Vector_t<Pair_t<UInt_t, UInt_t>> &vNumCuts);
+        /// @brief the via in default mode
+        const LefVia & via(UInt_t lowerMetalLayer, UInt_t row, UInt_t col) const
+        {
+          return _vDefaultVias.at(lowerMetalLayer).at(row - LefViaTable::MIN_GENERATE_ROW, col - LefViaTable::MIN_GENERATE_COLUMN);
+        }
+        /// @brief the via with metal shapes fitted to the connected wires
+        /// @param the target width/height of the bottom and top metals. <= 0 if don't care
+        const LefVia & via(UInt_t lowerMetalLayer, UInt_t row, UInt_t col,
+                           Int_t botWidth, Int_t botHeight, Int_t topWidth, Int_t topHeight) const
+        {
+          const Int_t begin = _vClassBegins.at(protoIdx(lowerMetalLayer, row, col));
+          if (begin == FIXED_VIA)
+          {
+            return via(lowerMetalLayer, row, col);
+          }
+          assert(begin != NO_VIA); // (row, col) not given to build()
+          return _vVias.at(begin + sideClass(botWidth, botHeight) * numClasses() + sideClass(topWidth, topHeight));
+        }
+    private:
+        static constexpr Int_t FIXED_VIA = -1; ///< not configurable, the default via fits every class
+        static constexpr Int_t NO_VIA = -2; ///< configurable, but not built for the classes
+
+        Vector_t<Vector2D<LefVia>> _vDefaultVias; ///< _vDefaultVias[layer][# of rows][# of columns] = via
+        Vector_t<Int_t>            _vClassBegins; ///< flattened [layer][# of rows][# of columns] = index of class (0, 0) in _vVias, or FIXED_VIA / NO_VIA
+        Vector_t<LefVia>           _vVias; ///< a [bottom class][top class] block per built configurable via
+        Vector_t<Int_t>            _vWireWidths; ///< sorted and unique
+
+        UInt_t numClasses() const { return 1 + 3 * _vWireWidths.size(); }
+        UInt_t sideClass(Int_t width, Int_t height) const;
+        void   classWidthHeight(UInt_t c, Int_t &width, Int_t &height) const;
+        UInt_t protoIdx(UInt_t lowerMetalLayer, UInt_t row, UInt_t col) const
+        {
+          const UInt_t numRows = LefViaTable::MAX_GENERATE_ROW - LefViaTable::MIN_GENERATE_ROW + 1;
+          const UInt_t numCols = LefViaTable::MAX_GENERATE_COLUMN - LefViaTable::MIN_GENERATE_COLUMN + 1;
+          UInt_t idx = lowerMetalLayer;
+          idx = idx * numRows + (row - LefViaTable::MIN_GENERATE_ROW);
+          idx = idx * numCols + (col - LefViaTable::MIN_GENERATE_COLUMN);
+          return idx;
+        }
+};
+
 PROJECT_NAMESPACE_END
 
 #endif /// _DB_LEF_VIA_HPP_
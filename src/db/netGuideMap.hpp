@@ -0,0 +1,100 @@
+/**
+ * @file   netGuideMap.hpp
+ * @brief  Circuit Element - Route guide membership bitmap of a net
+ *
+ **/
+
+#ifndef _DB_NET_GUIDE_MAP_HPP_
+#define _DB_NET_GUIDE_MAP_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/box.hpp"
+
+#include <cstdint>
+
+PROJECT_NAMESPACE_START
+
+// One bit per routing grid point and layer over the bounding box of the
+// net's guides, set if the point is inside (or on) one of the guides.
+class NetGuideMap {
+ public:
+  NetGuideMap()
+    : _step(1), _offsetX(0), _offsetY(0),
+      _loGridX(0), _loGridY(0), _numGridsX(0), _numGridsY(0) {}
+  ~NetGuideMap() {}
+
+  void init(const Int_t numLayers, const Int_t step, const Int_t offsetX, const Int_t offsetY,
+            const Vector_t<Pair_t<Box<Int_t>, Int_t>>& vGuides) {
+    _step = step;
+    _offsetX = offsetX;
+    _offsetY = offsetY;
+    _vvBits.assign(numLayers, Vector_t<std::uint64_t>());
+    _numGridsX = _numGridsY = 0;
+    if (vGuides.empty())
+      return;
+    Int_t xl = MAX_INT, yl = MAX_INT, xh = MIN_INT, yh = MIN_INT;
+    for (const Pair_t<Box<Int_t>, Int_t>& pair : vGuides) {
+      xl = std::min(xl, pair.first.xl());
+      yl = std::min(yl, pair.first.yl());
+      xh = std::max(xh, pair.first.xh());
+      yh = std::max(yh, pair.first.yh());
+    }
+    _loGridX = ceilGrid(xl - offsetX);
+    _loGridY = ceilGrid(yl - offsetY);
+    _numGridsX = std::max(floorGrid(xh - offsetX) - _loGridX + 1, 0);
+    _numGridsY = std::max(floorGrid(yh - offsetY) - _loGridY + 1, 0);
+    const Int_t numWords = (_numGridsX * _numGridsY + 63) / 64;
+    for (const Pair_t<Box<Int_t>, Int_t>& pair : vGuides) {
+      Vector_t<std::uint64_t>& vBits = _vvBits[pair.second];
+      if (vBits.empty()) {
+        vBits.resize(numWords, 0);
+      }
+      const Box<Int_t>& box = pair.first;
+      const Int_t gxl = ceilGrid(box.xl() - offsetX) - _loGridX;
+      const Int_t gyl = ceilGrid(box.yl() - offsetY) - _loGridY;
+      const Int_t gxh = floorGrid(box.xh() - offsetX) - _loGridX;
+      const Int_t gyh = floorGrid(box.yh() - offsetY) - _loGridY;
+      for (Int_t gy = gyl; gy <= gyh; ++gy) {
+        for (Int_t gx = gxl; gx <= gxh; ++gx) {
+          const Int_t i = gy * _numGridsX + gx;
+          vBits[i / 64] |= (std::uint64_t)1 << (i % 64);
+        }
+      }
+    }
+  }
+
+  // (x, y) must be a routing grid point
+  bool bInside(const Int_t layerIdx, const Int_t x, const Int_t y) const {
+    assert((x - _offsetX) % _step == 0 and (y - _offsetY) % _step == 0);
+    const Vector_t<std::uint64_t>& vBits = _vvBits[layerIdx];
+    if (vBits.empty())
+      return false;
+    const Int_t gx = (x - _offsetX) / _step - _loGridX;
+    const Int_t gy = (y - _offsetY) / _step - _loGridY;
+    if (gx < 0 or gy < 0 or gx >= _numGridsX or gy >= _numGridsY)
+      return false;
+    const Int_t i = gy * _numGridsX + gx;
+    return (vBits[i / 64] >> (i % 64)) & 1;
+  }
+
+ private:
+  Int_t _step;
+  Int_t _offsetX;
+  Int_t _offsetY;
+  Int_t _loGridX;
+  Int_t _loGridY;
+  Int_t _numGridsX;
+  Int_t _numGridsY;
+  Vector_t<Vector_t<std::uint64_t>> _vvBits; // empty for layers without guides
+
+  Int_t floorGrid(const Int_t d) const {
+    return d >= 0 ? d / _step : -((-d + _step - 1) / _step);
+  }
+  Int_t ceilGrid(const Int_t d) const {
+    return -floorGrid(-d);
+  }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _DB_NET_GUIDE_MAP_HPP_
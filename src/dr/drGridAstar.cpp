@@ -8,20 +8,26 @@
 
 #include "drGridAstar.hpp"
 #include "src/ds/pqueue.hpp"
-#include "src/geo/kdtree.hpp"
-#include "src/acs/acsMgr.hpp"
 #include "src/geo/box2polygon.hpp"
+#include "src/geo/boxTree.hpp"
 #include "src/graph/mst.hpp"
 
 #include <lemon/maps.h>
 #include <lemon/kruskal.h>
 #include <lemon/list_graph.h>
 
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+
 PROJECT_NAMESPACE_START
 
-bool DrGridAstar::run() {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::run() {
   
-  fprintf(stderr, "DrGridAstar::%s\tRoute net %s, Sym: %d, SelfSym: %d, StrictDRC: %d \n",
+  fprintf(stderr, "%s::%s\tRoute net %s, Sym: %d, SelfSym: %d, StrictDRC: %d \n",
+          CostPolicy::name(),
           __func__,
           _net.name().c_str(),
           _bSym,
@@ -36,6 +42,8 @@ bool DrGridAstar::run() {
   }
 
   init();
+  initNodeArena();
+  initShapeCache();
   splitSubNetMST();
 
   // route net with sym and self-sym constraint
@@ -43,15 +51,34 @@ bool DrGridAstar::run() {
 
   // ripup or not
   if (!bSuccess) {
-    fprintf(stderr, "DrGridAstar::%s\tERROR: Route net %s failed!\n", __func__, _net.name().c_str());
-    ripup();
+    if (!bCancelled()) {
+      fprintf(stderr, "%s::%s\tERROR: Route net %s failed!\n", CostPolicy::name(), __func__, _net.name().c_str());
+    }
+    if (!_bDeferCommit) {
+      ripup();
+    }
     return false;
   }
-  saveResult2Net();
+  if (!_bDeferCommit) {
+    saveResult2Net();
+  }
   return true;
 }
 
-void DrGridAstar::initSelfSym()
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::commit() {
+  assert(_bDeferCommit);
+  for (const auto& vRoutedWires : _vvRoutedWires) {
+    for (const auto& pair : vRoutedWires) {
+      _cir.addSpatialRoutedWire(_net.idx(), pair.second, pair.first);
+      _dr.addWireHistoryCost(_param.historyCost, pair.second, pair.first);
+    }
+  }
+  saveResult2Net();
+}
+
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::initSelfSym()
 {
   assert(_ro.numRoutables() == 0);
   UInt_t i, pinIdx, layerIdx;
@@ -91,11 +118,12 @@ void DrGridAstar::initSelfSym()
   }
   _compDS.init(numHalfPins);
   _vCompBoxes.resize(numHalfPins);
-  _vCompAcsPts.resize(numHalfPins);
+  _vCompAcsBoxes.resize(numHalfPins);
   _vCompSpatialBoxes.resize(numHalfPins);
 }
 
-void DrGridAstar::init() {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::init() {
   _vPinIdx.clear();
   _bSelfSymHasPinInBothSide = false;
   if (_bSelfSym) {
@@ -111,7 +139,7 @@ void DrGridAstar::init() {
     }
     _compDS.init(_ro.numPins() + _ro.numRoutables());
     _vCompBoxes.resize(_ro.numPins() + _ro.numRoutables());
-    _vCompAcsPts.resize(_ro.numPins() + _ro.numRoutables());
+    _vCompAcsBoxes.resize(_ro.numPins() + _ro.numRoutables());
     _vCompSpatialBoxes.resize(_ro.numPins() + _ro.numRoutables());
   }
 
@@ -121,8 +149,6 @@ void DrGridAstar::init() {
   const Box<Int_t>* cpBox;
   const AcsPt* cpPt;
   for (i = 0; i < _vPinIdx.size(); ++ i) {
-    _vCompAcsPts[i].set_empty_key(Point3d<Int_t>(MIN_INT, MIN_INT, MIN_INT));
-    _vCompAcsPts[i].set_deleted_key(Point3d<Int_t>(MAX_INT, MAX_INT, MAX_INT));
     const Int_t pinIdx = _vPinIdx[i];
     const auto& pin = _cir.pin(pinIdx);
     Pin_ForEachLayerIdx(pin, layerIdx) {
@@ -136,15 +162,12 @@ void DrGridAstar::init() {
 
     Pin_ForEachAcsPt(pin, cpPt, j) {
       Point3d<Int_t> pt = cpPt->gridPt();
-      _vCompAcsPts[i].insert(pt);
+      _vCompAcsBoxes[i].emplace_back(Box<Int_t>(pt.x(), pt.y(), pt.x(), pt.y()), pt.z());
       _pinAcsMap[pt] = *cpPt;
     }
   }
   for (i = 0; i < _vRoutableIdx.size(); ++i) {
     const Int_t compIdx = i + _vPinIdx.size();
-    _vCompAcsPts[compIdx].set_empty_key(Point3d<Int_t>(MIN_INT, MIN_INT, MIN_INT));
-    _vCompAcsPts[compIdx].set_deleted_key(Point3d<Int_t>(MAX_INT, MAX_INT, MAX_INT));
-    
     const Int_t routableIdx = _vRoutableIdx[i];
     const auto& routable = _net.routable(routableIdx);
     
@@ -161,7 +184,7 @@ void DrGridAstar::init() {
       }
       Pin_ForEachAcsPt(pin, cpPt, k) {
         Point3d<Int_t> pt = cpPt->gridPt();
-        _vCompAcsPts[compIdx].insert(pt);
+        _vCompAcsBoxes[compIdx].emplace_back(Box<Int_t>(pt.x(), pt.y(), pt.x(), pt.y()), pt.z());
         _pinAcsMap[pt] = *cpPt;
       }
 
@@ -192,9 +215,6 @@ void DrGridAstar::init() {
     Int_t xWidth = _cir.gridStep();
     Box<Int_t> dummyPinRect(_net.symAxisX() - xWidth, yRangeLo,
                             _net.symAxisX() + xWidth, yRangeHi);
-    _vCompAcsPts[dummyIdx].set_empty_key(Point3d<Int_t>(MIN_INT, MIN_INT, MIN_INT));
-    _vCompAcsPts[dummyIdx].set_deleted_key(Point3d<Int_t>(MAX_INT, MAX_INT, MAX_INT));
-    
     Cir_ForEachLayerIdx(_cir, layerIdx) {
       if (_cir.lef().bRoutingLayer(layerIdx)) {
         _vCompBoxes[dummyIdx].emplace_back(dummyPinRect, layerIdx);
@@ -207,12 +227,21 @@ void DrGridAstar::init() {
     }
     Int_t gridYLo = std::ceil(static_cast<Float_t>(yRangeLo - _cir.gridOffsetY()) / _cir.gridStep());
     Int_t gridYHi = std::floor(static_cast<Float_t>(yRangeHi - _cir.gridOffsetY()) / _cir.gridStep());
+    // the whole grid column on the axis is one target box per layer
+    if (gridYLo <= gridYHi) {
+      Cir_ForEachLayerIdx(_cir, layerIdx) {
+        if (_cir.lef().bRoutingLayer(layerIdx)) {
+          _vCompAcsBoxes[dummyIdx].emplace_back(Box<Int_t>(_cir.gridCenterX(gridX), _cir.gridCenterY(gridYLo),
+                                                           _cir.gridCenterX(gridX), _cir.gridCenterY(gridYHi)),
+                                                layerIdx);
+        }
+      }
+    }
     for (Int_t yIdx = gridYLo; yIdx <= gridYHi; ++yIdx)
     {
       Cir_ForEachLayerIdx(_cir, layerIdx) {
         if (_cir.lef().bRoutingLayer(layerIdx)) {
           Point3d<Int_t> pt = Point3d<Int_t>(_cir.gridCenterX(gridX), _cir.gridCenterY(yIdx), layerIdx);
-          _vCompAcsPts[dummyIdx].insert(pt);
           _pinAcsMap[pt] = AcsPt(pt, AcsPt::DirType::WEST);
         }
       }
@@ -220,34 +249,69 @@ void DrGridAstar::init() {
   }
 }
 
-void DrGridAstar::splitSubNetMST() {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::initNodeArena() {
+  // neighbors may step one grid outside the window
+  Box<Int_t> bound(_window);
+  bound.expand(_cir.gridStep());
+  for (const auto& acsBoxes : _vCompAcsBoxes) {
+    for (const auto& pair : acsBoxes) {
+      bound.coverPoint(pair.first.min_corner());
+      bound.coverPoint(pair.first.max_corner());
+    }
+  }
+  _nodeArena.init(_cir.lef().numLayers(), _cir.gridStep(),
+                  _cir.gridOffsetX(), _cir.gridOffsetY(), bound);
+  if (_param.bBidirectional) {
+    _revNodeArena.init(_cir.lef().numLayers(), _cir.gridStep(),
+                       _cir.gridOffsetX(), _cir.gridOffsetY(), bound);
+  }
+}
+
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::splitSubNetMST() {
   // init pins
-  UInt_t i, j;
+  UInt_t i;
   UInt_t numRealPins = _vCompBoxes.size();
   if (!_bSelfSymHasPinInBothSide and _bSelfSym)
   {
     --numRealPins; // Remove the dummy
   }
 
-  // compute cost value of each edge
-  MinimumSpanningTree<Int_t> mst(numRealPins);
+  // the bounding box of each pin gives a lower bound of the pin distance,
+  // the exact distance is only computed for the pairs Kruskal gets to
+  Vector_t<Pair_t<Box<Int_t>, Pair_t<Int_t, Int_t>>> vCompBBoxes(numRealPins);
   for (i = 0; i < numRealPins; ++i) {
-    for (j = i + 1; j < numRealPins; ++j) {
-      Int_t minDist = MAX_INT;
-      for (const auto& u : _vCompBoxes[i]) {
-        for (const auto& v : _vCompBoxes[j]) {
-          Int_t dist = scaledMDist(u, v);
-          if (dist < minDist) {
-            minDist = dist;
-          }
-        }
-      }
-      AssertMsg(minDist != MAX_INT, "net %s check i %d j %d \n", _net.name().c_str(), i, j);
-      mst.addEdge(i, j, minDist);
+    Box<Int_t> bbox;
+    bbox.setBounds(MAX_INT, MAX_INT, MIN_INT, MIN_INT);
+    Int_t zl = MAX_INT, zh = MIN_INT;
+    for (const auto& u : _vCompBoxes[i]) {
+      bbox.setBounds(std::min(bbox.xl(), u.first.xl()), std::min(bbox.yl(), u.first.yl()),
+                     std::max(bbox.xh(), u.first.xh()), std::max(bbox.yh(), u.first.yh()));
+      zl = std::min(zl, u.second);
+      zh = std::max(zh, u.second);
     }
+    vCompBBoxes[i] = std::make_pair(bbox, std::make_pair(zl, zh));
   }
-  
-  mst.solve(_vSubNets);
+  auto lowerBound = [&] (const Int_t u, const Int_t v) {
+    if (_vCompBoxes[u].empty() or _vCompBoxes[v].empty())
+      return (Int_t)0;
+    const auto& bu = vCompBBoxes[u];
+    const auto& bv = vCompBBoxes[v];
+    const Int_t dz = std::max({bu.second.first - bv.second.second, bv.second.first - bu.second.second, (Int_t)0});
+    return scaledMDist(bu.first, bv.first) + dz * _param.viaCost;
+  };
+  auto minDist = [&] (const Int_t u, const Int_t v) {
+    Int_t minDist = MAX_INT;
+    for (const auto& bu : _vCompBoxes[u]) {
+      for (const auto& bv : _vCompBoxes[v]) {
+        minDist = std::min(minDist, scaledMDist(bu, bv));
+      }
+    }
+    AssertMsg(minDist != MAX_INT, "net %s check i %d j %d \n", _net.name().c_str(), u, v);
+    return minDist;
+  };
+  lazyKruskal<Int_t>(numRealPins, lowerBound, minDist, _vSubNets);
 
   // Handle the dummy case
   if (!_bSelfSymHasPinInBothSide and _bSelfSym)
@@ -274,7 +338,8 @@ void DrGridAstar::splitSubNetMST() {
   }
 }
 
-bool DrGridAstar::route() {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::route() {
   for (const auto& pair : _vSubNets) {
     const Int_t srcIdx = pair.first;
     const Int_t tarIdx = pair.second;
@@ -285,178 +350,453 @@ bool DrGridAstar::route() {
   return true;
 }
 
-bool DrGridAstar::routeSubNet(Int_t srcIdx, Int_t tarIdx) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::routeSubNet(Int_t srcIdx, Int_t tarIdx) {
   assert(_compDS.find(srcIdx) != _compDS.find(tarIdx));
   
-  // init source and target access point sets
   srcIdx = _compDS.find(srcIdx);
   tarIdx = _compDS.find(tarIdx);
-  auto& src = _vCompAcsPts[srcIdx]; // DenseHashSet
-  auto& tar = _vCompAcsPts[tarIdx]; // DenseHashSet
 
-  // reset nodes cost
-  resetAllNodes();
+  // only search again if the last path of this subnet became invalid
+  if (_param.bReusePath and bReuseSubNetPath(srcIdx, tarIdx))
+    return true;
 
-  // init access points to node maps
-  // memory free in destructor
-  for (const auto& p : src) { // p: Point3d<Int>
-    Point<Int_t> p2d(p.x(), p.y());
-    if (_vAllNodesMap[p.z()].find(p2d) == _vAllNodesMap[p.z()].end()) {
-      _vAllNodesMap[p.z()][p2d] = new DrGridAstarNode(p);
+  // search a window around the two components first,
+  // grow it geometrically on failure until it covers the whole window
+  Box<Int_t> bbox;
+  bbox.setBounds(MAX_INT, MAX_INT, MIN_INT, MIN_INT);
+  for (const Int_t compIdx : {srcIdx, tarIdx}) {
+    for (const auto& pair : _vCompAcsBoxes[compIdx]) {
+      bbox.coverPoint(pair.first.min_corner());
+      bbox.coverPoint(pair.first.max_corner());
     }
   }
-  for (const auto& p : tar) { // p: Point3d<Int>
-    Point<Int_t> p2d(p.x(), p.y());
-    if (_vAllNodesMap[p.z()].find(p2d) == _vAllNodesMap[p.z()].end()) {
-      _vAllNodesMap[p.z()][p2d] = new DrGridAstarNode(p);
+  Int_t margin = _param.windowMargin * _cir.gridStep();
+  while (true) {
+    const bool bFull = bbox.xl() > bbox.xh() // no access point to center on
+                   or (bbox.xl() - margin <= _window.xl() and bbox.xh() + margin >= _window.xh()
+                       and bbox.yl() - margin <= _window.yl() and bbox.yh() + margin >= _window.yh());
+    if (bFull) {
+      _searchWindow = _window;
     }
-  }
+    else {
+      _searchWindow.setBounds(std::max(bbox.xl() - margin, _window.xl()), std::max(bbox.yl() - margin, _window.yl()),
+                              std::min(bbox.xh() + margin, _window.xh()), std::min(bbox.yh() + margin, _window.yh()));
+    }
+    // the open list may hold a fixed fraction of the nodes in the window
+    const Float_t numNodes = static_cast<Float_t>(_searchWindow.width() / _cir.gridStep() + 1)
+                           * (_searchWindow.height() / _cir.gridStep() + 1)
+                           * _cir.lef().numRoutingLayers();
+    _searchBudget = static_cast<Int_t>(std::min(numNodes * _param.exploreRatio,
+                                                static_cast<Float_t>(_param.maxExplore)));
+    // reset nodes cost
+    resetAllNodes();
 
-  return pathSearch(srcIdx, tarIdx);
+    const bool bSuccess = _param.bBidirectional ? bidirPathSearch(srcIdx, tarIdx)
+                                                : pathSearch(srcIdx, tarIdx);
+    if (bSuccess)
+      return true;
+    if (bFull or bCancelled())
+      return false;
+    margin *= _param.windowGrowth;
+  }
 }
 
- bool DrGridAstar::pathSearch(const Int_t srcIdx, const Int_t tarIdx) {
-  auto& src = _vCompAcsPts[srcIdx]; // DenseHashSet
-  auto& tar = _vCompAcsPts[tarIdx]; // DenseHashSet
-  
-  // init KD-Tree of tar
-  K3dTree<Int_t> tarKD;
-  for (const auto& p : tar) {
-    tarKD.insert(p.x() * _param.horCost,
-                 p.y() * _param.verCost,
-                 p.z() * _param.viaCost);
-  }
-  tarKD.buildIndex();
+// A* heuristic toward a set of grid-snapped target boxes: scaled manhattan
+// distance to the nearest box, or the cheaper bound to their bounding box.
+// Box corners are grid points, so the distance to the nearest box equals the
+// distance to the nearest grid point inside it.
+// It only depends on the node, so it is computed once per search.
+// The boxes of each layer sit in a BoxTree, after merging access points that
+// are grid neighbors into segments and stacked equal segments into boxes, so
+// both the distance and the membership test are logarithmic.
+template <typename CostPolicy>
+struct DrGridAstarKernel<CostPolicy>::Heuristic {
+  Heuristic(const DrGridAstarKernel& astar, const List_t<Pair_t<Box<Int_t>, Int_t>>& tar)
+    : param(astar._param),
+      xl(MAX_INT), yl(MAX_INT), zl(MAX_INT),
+      xh(MIN_INT), yh(MIN_INT), zh(MIN_INT),
+      vTrees(astar._cir.lef().numLayers()) {
+    Vector_t<Vector_t<Box<Int_t>>> vvBoxes(vTrees.size());
+    for (const auto& pair : tar) {
+      const Box<Int_t>& box = pair.first;
+      xl = std::min(xl, box.xl()); xh = std::max(xh, box.xh());
+      yl = std::min(yl, box.yl()); yh = std::max(yh, box.yh());
+      zl = std::min(zl, pair.second); zh = std::max(zh, pair.second);
+      vvBoxes[pair.second].emplace_back(box);
+    }
+    for (Int_t z = 0; z < (Int_t)vvBoxes.size(); ++z) {
+      if (vvBoxes[z].empty())
+        continue;
+      mergePoints(vvBoxes[z], astar._cir.gridStep());
+      vTrees[z].build(vvBoxes[z]);
+    }
+  }
+
+  Int_t operator () (DrGridAstarNode* pNode) {
+    if (pNode->costH() == MAX_INT) {
+      const auto& p = pNode->coord();
+      Int_t dist = 0;
+      if (param.bBoxHeuristic) {
+        dist += std::max(std::max(xl - p.x(), p.x() - xh), 0) * param.horCost;
+        dist += std::max(std::max(yl - p.y(), p.y() - yh), 0) * param.verCost;
+        dist += std::max(std::max(zl - p.z(), p.z() - zh), 0) * param.viaCost;
+      }
+      else {
+        dist = MAX_INT;
+        for (Int_t z = zl; z <= zh and dist > 0; ++z) {
+          const Int_t distZ = std::abs(z - p.z()) * param.viaCost;
+          if (vTrees[z].empty() or distZ >= dist)
+            continue;
+          dist = distZ + vTrees[z].nearestDist(p.x(), p.y(), param.horCost, param.verCost, dist - distZ);
+        }
+        if (dist == MAX_INT) // no target
+          dist = 0;
+      }
+      pNode->setCostH(dist);
+    }
+    return pNode->costH();
+  }
+
+  // u \in tar
+  bool bTarget(const DrGridAstarNode* pNode) const {
+    const auto& p = pNode->coord();
+    if (p.z() < zl or p.z() > zh)
+      return false;
+    return vTrees[p.z()].exist(p.x(), p.y());
+  }
+
+  // replace the single grid points by horizontal runs of neighbors,
+  // then stack runs with equal x ranges on neighboring rows into boxes
+  static void mergePoints(Vector_t<Box<Int_t>>& vBoxes, const Int_t step) {
+    auto bPoint = [] (const Box<Int_t>& b) { return b.xl() == b.xh() and b.yl() == b.yh(); };
+    auto it = std::partition(vBoxes.begin(), vBoxes.end(), [&] (const Box<Int_t>& b) { return !bPoint(b); });
+    Vector_t<Box<Int_t>> vRuns;
+    std::sort(it, vBoxes.end(), [] (const Box<Int_t>& a, const Box<Int_t>& b) {
+      return a.yl() != b.yl() ? a.yl() < b.yl() : a.xl() < b.xl();
+    });
+    for (auto jt = it; jt != vBoxes.end(); ++jt) {
+      if (!vRuns.empty() and vRuns.back().yl() == jt->yl() and vRuns.back().xh() + step >= jt->xl())
+        vRuns.back().setXH(std::max(vRuns.back().xh(), jt->xh()));
+      else
+        vRuns.emplace_back(*jt);
+    }
+    vBoxes.erase(it, vBoxes.end());
+    std::sort(vRuns.begin(), vRuns.end(), [] (const Box<Int_t>& a, const Box<Int_t>& b) {
+      return std::make_tuple(a.xl(), a.xh(), a.yl()) < std::make_tuple(b.xl(), b.xh(), b.yl());
+    });
+    const size_t numBoxes = vBoxes.size();
+    for (const Box<Int_t>& run : vRuns) {
+      if (vBoxes.size() > numBoxes and vBoxes.back().xl() == run.xl() and vBoxes.back().xh() == run.xh()
+          and vBoxes.back().yh() + step == run.yl())
+        vBoxes.back().setYH(run.yh());
+      else
+        vBoxes.emplace_back(run);
+    }
+  }
+
+  const Param&                param;
+  Int_t                       xl, yl, zl, xh, yh, zh;
+  Vector_t<BoxTree<Int_t>>    vTrees; // target boxes of each layer
+};
+
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::pathSearch(const Int_t srcIdx, const Int_t tarIdx) {
+  const auto& src = _vCompAcsBoxes[srcIdx];
+  const auto& tar = _vCompAcsBoxes[tarIdx];
   
-  // init Astar priority queue
-  using PQueue_t = PairingHeap<DrGridAstarNode*, DrGridAstarNodeCmp>;
-  using Itermap_t = DenseHashMap<DrGridAstarNode*, PQueue_t::point_iterator>;
-  PQueue_t pq;
-  Itermap_t itMap;
-  itMap.set_empty_key(nullptr);
+  // init Astar heuristic and priority queue
+  Heuristic costH(*this, tar);
+  IndexedHeap<DrGridAstarNode> pq;
 
   // add src points to pq
-  for (const auto& p : src) {
-    Point<Int_t> p2d(p.x(), p.y());
-    Int_t layerIdx = p.z();
-    Point3d<Int_t> scaledP(p.x() * _param.horCost,
-                           p.y() * _param.verCost,
-                           p.z() * _param.viaCost);
-    Point3d<Int_t> scaledNearestP;
-    Int_t scaledNearestDist = MAX_INT;
-    tarKD.nearestSearch(scaledP, scaledNearestP, scaledNearestDist);
-    assert(_vAllNodesMap[layerIdx].find(p2d) != _vAllNodesMap[layerIdx].end());
-    DrGridAstarNode* pNode = _vAllNodesMap[layerIdx][p2d];
-    Int_t costF = _param.factorH * scaledNearestDist;
-    if (bInsideGuide(pNode)) {
-      costF += _param.guideCost;
-    }
-    pNode->setCostF(costF);
-    pNode->setCostG(0);
-    pNode->setBendCnt(0);
-    //pNode->setDist2Tar()
-    itMap[pNode] = pq.push(pNode);
-  }
+  initFrontier(src, _nodeArena, costH, pq);
   
   // start exploring nodes
-  while (!pq.empty() and (Int_t)pq.size() < _param.maxExplore) {
+  while (!pq.empty() and (Int_t)pq.size() < _searchBudget) {
+    if (bCancelled())
+      return false;
     DrGridAstarNode* pU = pq.top();
-    if (bFindAcsPt(pU, tarIdx)) { // u \in tar
+    if (costH.bTarget(pU)) { // u \in tar
       const UInt_t bigCompIdx = mergeComp(srcIdx, tarIdx);
       //connect2AcsPt(pU);
       backTrack(pU, bigCompIdx, srcIdx, tarIdx);
       return true;
     }
     pq.pop();
-    pU->setExplored(true);
-    if (pU->vpNeighbors().empty()) {
-      findNeighbors(pU);
+    expandNode(pU, _nodeArena, costH, pq, false, srcIdx, tarIdx);
+  }
+  return false;
+}
+
+// Bidirectional A*: a meeting node whose two parent chains join gives a
+// path of cost (costG forward + costG backward + the penalties both end
+// nodes carry in costF, bends of both + the bend at the meeting node).
+// The penalties are the guide, DRC, history and edge costs that the
+// unidirectional search adds to costF. Without them a meeting over a DRC
+// violation of the relaxed search would beat a clean one.
+// The best candidate so far is kept as mu. The search stops once the open
+// list of either side cannot lead to a cheaper path, i.e. the smallest
+// (costG + costH, bendCnt) over its open nodes is not below mu, after
+// lowering it by the guide bonus both end nodes may still get, the only
+// negative penalty. The open lists themselves are ordered by the usual
+// costF keys.
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bidirPathSearch(const Int_t srcIdx, const Int_t tarIdx) {
+  const auto& src = _vCompAcsBoxes[srcIdx];
+  const auto& tar = _vCompAcsBoxes[tarIdx];
+
+  // forward search from src to tar, backward search from tar to src
+  Heuristic fwdCostH(*this, tar);
+  Heuristic bwdCostH(*this, src);
+  IndexedHeap<DrGridAstarNode> fwdPq;
+  IndexedHeap<DrGridAstarNode> bwdPq;
+  initFrontier(src, _nodeArena, fwdCostH, fwdPq);
+  initFrontier(tar, _revNodeArena, bwdCostH, bwdPq);
+
+  // costF minus the distance terms
+  auto penalty = [&] (const DrGridAstarNode* pNode) -> std::int64_t {
+    return (std::int64_t)pNode->costF() - (std::int64_t)pNode->costG() * _param.factorG
+                                        - (std::int64_t)pNode->costH() * _param.factorH;
+  };
+  bool bHasGuide = false;
+  for (const auto& guides : _cir.vSpatialNetGuides(_net.idx())) {
+    bHasGuide |= !guides.empty();
+  }
+  const std::int64_t minPenalty = bHasGuide ? 2 * (std::int64_t)std::min(_param.guideCost, 0) : 0;
+
+  // lower bounds of the open nodes of each side, stale entries are dropped lazily
+  typedef Pair_t<std::int64_t, DrGridAstarNode*> BoundEntry;
+  typedef std::priority_queue<BoundEntry, Vector_t<BoundEntry>, std::greater<BoundEntry>> BoundHeap;
+  auto boundKey = [&] (const DrGridAstarNode* pNode) -> std::int64_t {
+    const std::int64_t f = (std::int64_t)pNode->costG() * _param.factorG + (std::int64_t)pNode->costH() * _param.factorH;
+    return (f + minPenalty) * ((std::int64_t)1 << 32) + pNode->bendCnt();
+  };
+  auto minBound = [&] (BoundHeap& bounds) -> std::int64_t {
+    while (!bounds.empty()) {
+      const BoundEntry& e = bounds.top();
+      if (!e.second->bExplored() and e.second->heapIdx() >= 0 and boundKey(e.second) == e.first)
+        return e.first;
+      bounds.pop();
     }
-    for (auto pV : pU->vpNeighbors()) {
-      if (pV->bExplored())
-        continue;
-      const Int_t costG = pU->costG() + scaledMDist(pU->coord(), pV->coord());
-      const Int_t bendCnt = pU->bendCnt() + hasBend(pU, pV);
-      if (bNeedUpdate(pV, costG, bendCnt)) {
-        Point3d<Int_t> scaledP(pV->coord().x() * _param.horCost,
-                               pV->coord().y() * _param.verCost,
-                               pV->coord().z() * _param.viaCost);
-        Point3d<Int_t> scaledNearestP;
-        Int_t scaledNearestDist;
-        tarKD.nearestSearch(scaledP, scaledNearestP, scaledNearestDist);
-        Int_t costF = (costG * _param.factorG + scaledNearestDist * _param.factorH);
-        if (bViolateDRC(pU, pV, srcIdx, tarIdx)) {
-          if (_bStrictDRC) // do not allow any DRC violation
-            continue;
-          else // add high cost to DRC violations
-            costF += _param.drcCost;
+    return std::numeric_limits<std::int64_t>::max();
+  };
+  auto initBounds = [&] (const List_t<Pair_t<Box<Int_t>, Int_t>>& comp, DrGridAstarNodeArena& arena, BoundHeap& bounds) {
+    for (const auto& pair : comp) {
+      const Box<Int_t>& box = pair.first;
+      for (Int_t x = box.xl(); x <= box.xh(); x += _cir.gridStep()) {
+        for (Int_t y = box.yl(); y <= box.yh(); y += _cir.gridStep()) {
+          DrGridAstarNode* pNode = arena.node(Point3d<Int_t>(x, y, pair.second));
+          bounds.emplace(boundKey(pNode), pNode);
         }
-        if (bStackedVia(pU, pV)) {
-          //costF += _param.stackedViaCost;
-          continue;
-        }
-        if (bInsideGuide(pV)) {
+      }
+    }
+  };
+  BoundHeap fwdBounds, bwdBounds;
+  initBounds(src, _nodeArena, fwdBounds);
+  initBounds(tar, _revNodeArena, bwdBounds);
+
+  std::int64_t mu = std::numeric_limits<std::int64_t>::max();
+  DrGridAstarNode* pBestF = nullptr;
+  DrGridAstarNode* pBestB = nullptr;
+
+  // expand the smaller frontier until neither side can improve mu
+  while (!fwdPq.empty() and !bwdPq.empty()
+         and (Int_t)(fwdPq.size() + bwdPq.size()) < _searchBudget) {
+    if (bCancelled())
+      return false;
+    if (pBestF and std::max(minBound(fwdBounds), minBound(bwdBounds)) >= mu)
+      break;
+    const bool bReverse = bwdPq.size() < fwdPq.size();
+    auto& pq = bReverse ? bwdPq : fwdPq;
+    DrGridAstarNode* pU = pq.top();
+    // src and tar points are reached at the start, so this also covers u \in tar
+    DrGridAstarNode* pF = bReverse ? _nodeArena.node(pU->coord()) : pU;
+    DrGridAstarNode* pB = bReverse ? pU : _revNodeArena.node(pU->coord());
+    if (pF->costG() != MAX_INT and pB->costG() != MAX_INT and bCanMeet(pF, pB)) {
+      const std::int64_t cost = (std::int64_t)(pF->costG() + pB->costG()) * _param.factorG
+                              + penalty(pF) + penalty(pB);
+      const Int_t bendCnt = pF->bendCnt() + pB->bendCnt()
+                          + (pB->pParent() ? hasBend(pF, pB->pParent()) : 0);
+      const std::int64_t key = cost * ((std::int64_t)1 << 32) + bendCnt;
+      if (key < mu) {
+        mu = key;
+        pBestF = pF;
+        pBestB = pB;
+      }
+    }
+    pq.pop();
+    if (bReverse) {
+      expandNode(pU, _revNodeArena, bwdCostH, bwdPq, true, srcIdx, tarIdx);
+    }
+    else {
+      expandNode(pU, _nodeArena, fwdCostH, fwdPq, false, srcIdx, tarIdx);
+    }
+    // the neighbors updated by u have u as parent now
+    auto& bounds = bReverse ? bwdBounds : fwdBounds;
+    for (DrGridAstarNode* pV : _vpNeighbors) {
+      if (pV->pParent() == pU and pV->heapIdx() >= 0)
+        bounds.emplace(boundKey(pV), pV);
+    }
+  }
+  if (pBestF == nullptr)
+    return false;
+  const UInt_t bigCompIdx = mergeComp(srcIdx, tarIdx);
+  backTrack(pBestF, bigCompIdx, srcIdx, tarIdx, pBestB);
+  return true;
+}
+
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::initFrontier(const List_t<Pair_t<Box<Int_t>, Int_t>>& src,
+                                                 DrGridAstarNodeArena& arena, Heuristic& costH,
+                                                 IndexedHeap<DrGridAstarNode>& pq) {
+  const Int_t step = _cir.gridStep();
+  for (const auto& pair : src) {
+    const Box<Int_t>& box = pair.first;
+    for (Int_t x = box.xl(); x <= box.xh(); x += step) {
+      for (Int_t y = box.yl(); y <= box.yh(); y += step) {
+        DrGridAstarNode* pNode = arena.node(Point3d<Int_t>(x, y, pair.second));
+        Int_t costF = _param.factorH * costH(pNode);
+        if (bInsideGuide(pNode)) {
           costF += _param.guideCost;
         }
-        costF += history(pV);
-        pV->setParent(pU);
-        pV->setCostF(costF);
-        pV->setCostG(costG);
-        pV->setBendCnt(bendCnt);
-        auto it = itMap.find(pV);
-        if (it != itMap.end())
-          pq.modify(it->second, pV);
-        else
-          itMap[pV] = pq.push(pV);
+        pNode->setCostF(costF);
+        pNode->setCostG(0);
+        pNode->setBendCnt(0);
+        //pNode->setDist2Tar()
+        pq.update(pNode, pNode->heapKey());
       }
     }
   }
-  return false;
 }
 
-bool DrGridAstar::bFindAcsPt(const DrGridAstarNode* pU, const Int_t tarIdx) {
-  const auto& tar = _vCompAcsPts[tarIdx];
-  if (tar.find(pU->coord()) != tar.end()) {
-    //const AcsPt& acsPt = _pinAcsMap.at(pU->coord());
-    //if (findAcsDir(pU) == acsPt.dir())
-      return true;
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::expandNode(DrGridAstarNode* pU, DrGridAstarNodeArena& arena, Heuristic& costH,
+                                               IndexedHeap<DrGridAstarNode>& pq, const bool bReverse,
+                                               const Int_t srcIdx, const Int_t tarIdx) {
+  pU->setExplored(true);
+  findNeighbors(pU, arena, _vpNeighbors);
+  for (auto pV : _vpNeighbors) {
+    if (pV->bExplored())
+      continue;
+    const Int_t costG = pU->costG() + scaledMDist(pU->coord(), pV->coord());
+    const Int_t bendCnt = pU->bendCnt() + hasBend(pU, pV);
+    if (bNeedUpdate(pV, costG, bendCnt)) {
+      Int_t costF = (costG * _param.factorG + costH(pV) * _param.factorH);
+      if (bViolateDRC(pU, pV, srcIdx, tarIdx, bReverse)) {
+        if (_bStrictDRC) // do not allow any DRC violation
+          continue;
+        else // add high cost to DRC violations
+          costF += _param.drcCost;
+      }
+      if (bStackedVia(pU, pV)) {
+        //costF += _param.stackedViaCost;
+        continue;
+      }
+      if (bInsideGuide(pV)) {
+        costF += _param.guideCost;
+      }
+      costF += _cost.edgeCost(pU, pV);
+      costF += history(pV);
+      pV->setParent(pU);
+      updateRun(pV);
+      pV->setCostF(costF);
+      pV->setCostG(costG);
+      pV->setBendCnt(bendCnt);
+      pq.update(pV, pV->heapKey());
+    }
   }
-  return false;
 }
 
-Int_t DrGridAstar::mergeComp(const Int_t srcIdx, const Int_t tarIdx) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bCanMeet(const DrGridAstarNode* pF, const DrGridAstarNode* pB) {
+  const Int_t z = pF->coord().z();
+  const DrGridAstarNode* pFParent = pF->pParent();
+  const DrGridAstarNode* pBParent = pB->pParent();
+  // stacked via through the meeting node
+  if (pFParent and pBParent
+      and pFParent->coord().z() != z
+      and pBParent->coord().z() != z
+      and pFParent->coord().z() != pBParent->coord().z()) {
+    return false;
+  }
+  // the wire through the meeting node is split between the two searches,
+  // check its min area when it ends in a via toward the target like the forward search does
+  if (_bStrictDRC) {
+    const Int_t width = _net.minWidth();
+    const Int_t extension = width / 2;
+    Vector_t<Box<Int_t>> vWires;
+    const DrGridAstarNode* pN = pB;
+    while (pN->pParent() and pN->pParent()->coord().z() == z) {
+      Box<Int_t> wire;
+      toWire(pN->coord(), pN->pParent()->coord(), width, extension, wire);
+      vWires.emplace_back(wire);
+      pN = pN->pParent();
+    }
+    if (pN->pParent()) {
+      pN = pF;
+      while (pN->pParent() and pN->pParent()->coord().z() == z) {
+        Box<Int_t> wire;
+        toWire(pN->coord(), pN->pParent()->coord(), width, extension, wire);
+        vWires.emplace_back(wire);
+        pN = pN->pParent();
+      }
+      if (!drc().checkWireMinArea(z, vWires))
+        return false;
+    }
+  }
+  return true;
+}
+
+template <typename CostPolicy>
+Int_t DrGridAstarKernel<CostPolicy>::mergeComp(const Int_t srcIdx, const Int_t tarIdx) {
   _compDS.merge(srcIdx, tarIdx);
   Int_t bigCompIdx = srcIdx, smallCompIdx = tarIdx;
-  if (_vCompAcsPts[bigCompIdx].size() < _vCompAcsPts[smallCompIdx].size()) {
+  if (_vCompAcsBoxes[bigCompIdx].size() < _vCompAcsBoxes[smallCompIdx].size()) {
     std::swap(bigCompIdx, smallCompIdx);
   }
-  auto& bigComp = _vCompAcsPts[bigCompIdx];
-  auto& smallComp = _vCompAcsPts[smallCompIdx];
+  auto& bigComp = _vCompAcsBoxes[bigCompIdx];
+  auto& smallComp = _vCompAcsBoxes[smallCompIdx];
   if (_compDS.nSets() > 1) {
-    bigComp.insert(smallComp.begin(), smallComp.end());
+    bigComp.splice(bigComp.end(), smallComp);
   }
   return bigCompIdx;
 }
 
-void DrGridAstar::backTrack(const DrGridAstarNode* pU, const Int_t bigCompIdx, const Int_t srcIdx, const Int_t tarIdx) {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::backTrack(const DrGridAstarNode* pU, const Int_t bigCompIdx, const Int_t srcIdx, const Int_t tarIdx,
+                                              const DrGridAstarNode* pRevU) {
   List_t<Point3d<Int_t>> lPathPts;
   add2Path(pU, lPathPts);
   const DrGridAstarNode* pParent = pU->pParent();
-  if (pParent == nullptr)
+  // the rest of the path toward tar comes from the backward search
+  const DrGridAstarNode* pRevParent = pRevU ? pRevU->pParent() : nullptr;
+  if (pParent == nullptr and pRevParent == nullptr)
     return;
-  do {
+  while (pParent != nullptr) {
     add2Path(pParent, lPathPts);
     pParent = pParent->pParent();
-  } while (pParent != nullptr);
+  }
+  while (pRevParent != nullptr) {
+    lPathPts.emplace_back(pRevParent->coord());
+    pRevParent = pRevParent->pParent();
+  }
+  List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>> lPathVec;
+  mergePath(lPathPts, lPathVec);
+  addPath(lPathVec, bigCompIdx, srcIdx, tarIdx);
+}
+
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::addPath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec,
+                                            const Int_t bigCompIdx, const Int_t srcIdx, const Int_t tarIdx) {
   assert(_compDS.find(srcIdx) == _compDS.find(tarIdx));
   const Int_t rootIdx = _compDS.find(srcIdx);
   const Int_t childIdx = (rootIdx == srcIdx) ? tarIdx : srcIdx;
-  _vCompAcsPts[rootIdx] = _vCompAcsPts[bigCompIdx];
-  List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>> lPathVec;
-  mergePath(lPathPts, lPathVec);
-  
+  if (rootIdx != bigCompIdx) {
+    _vCompAcsBoxes[rootIdx].swap(_vCompAcsBoxes[bigCompIdx]);
+  }
   savePath(lPathVec);
-  
+
 
   // add to comp box
   for (const auto& pair : _vCompBoxes[childIdx]) {
@@ -489,11 +829,53 @@ void DrGridAstar::backTrack(const DrGridAstarNode* pU, const Int_t bigCompIdx, c
   }
 }
 
-void DrGridAstar::add2Path(const DrGridAstarNode* pU, List_t<Point3d<Int_t>>& lPathPts) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bReuseSubNetPath(const Int_t srcIdx, const Int_t tarIdx) {
+  // symmetric paths also own the mirrored shapes, search them again
+  if (_bSym or _bSelfSym)
+    return false;
+  Box<Int_t> bound(_window);
+  bound.expand(_cir.gridStep());
+  for (const auto& subNetPath : _dr._vvNetPathCache[_net.idx()]) {
+    const auto& vPath = subNetPath.vPath;
+    const Point3d<Int_t>& s = vPath.front().first;
+    const Point3d<Int_t>& t = vPath.back().second;
+    // the path must still connect the two components ...
+    if (!(bInsideComp(srcIdx, s) and bInsideComp(tarIdx, t))
+        and !(bInsideComp(srcIdx, t) and bInsideComp(tarIdx, s)))
+      continue;
+    // ... stay in the window ...
+    bool bInside = true;
+    for (const auto& pair : vPath) {
+      bInside &= Box<Int_t>::bConnect(bound, Point<Int_t>(pair.first.x(), pair.first.y()))
+             and Box<Int_t>::bConnect(bound, Point<Int_t>(pair.second.x(), pair.second.y()));
+    }
+    // ... and be clean against the shapes routed since
+    if (!bInside or !_dr.checkWiresDRC(_net.idx(), subNetPath.vWires))
+      continue;
+    const Int_t bigCompIdx = mergeComp(srcIdx, tarIdx);
+    addPath(List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>(vPath.begin(), vPath.end()), bigCompIdx, srcIdx, tarIdx);
+    return true;
+  }
+  return false;
+}
+
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bInsideComp(const Int_t compIdx, const Point3d<Int_t>& p) {
+  for (const auto& pair : _vCompAcsBoxes[compIdx]) {
+    if (pair.second == p.z() and Box<Int_t>::bConnect(pair.first, Point<Int_t>(p.x(), p.y())))
+      return true;
+  }
+  return false;
+}
+
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::add2Path(const DrGridAstarNode* pU, List_t<Point3d<Int_t>>& lPathPts) {
   lPathPts.emplace_front(pU->coord()); 
 }
 
-void DrGridAstar::mergePath(const List_t<Point3d<Int_t>>& lPathPts, List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec) {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::mergePath(const List_t<Point3d<Int_t>>& lPathPts, List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec) {
   if (lPathPts.size() == 1) {
     lPathVec.emplace_back(lPathPts.front(), lPathPts.front());
     return;
@@ -514,7 +896,8 @@ void DrGridAstar::mergePath(const List_t<Point3d<Int_t>>& lPathPts, List_t<Pair_
   lPathVec.emplace_back(*u1, *v1);
 }
 
-bool DrGridAstar::bNeedMergePath(const Point3d<Int_t>& u1, const Point3d<Int_t>& v1, const Point3d<Int_t>& u2, const Point3d<Int_t>& v2) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bNeedMergePath(const Point3d<Int_t>& u1, const Point3d<Int_t>& v1, const Point3d<Int_t>& u2, const Point3d<Int_t>& v2) {
   // path1: u1 -> v1, path2: u2 -> v2
   if (u1.z() != v1.z()) {
     assert(u1.x() == v1.x() and u1.y() == v1.y());
@@ -523,7 +906,8 @@ bool DrGridAstar::bNeedMergePath(const Point3d<Int_t>& u1, const Point3d<Int_t>&
   return findDir(u1, v1) == findDir(u2, v2);
 }
 
-void DrGridAstar::savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec) {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec) {
   _vvRoutePaths.resize(_vvRoutePaths.size() + 1);
   _vvRoutePaths.back().reserve(lPathVec.size());
   _vvRoutedWires.resize(_vvRoutedWires.size() + 1);
@@ -552,6 +936,8 @@ void DrGridAstar::savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>&
       Box<Int_t> wire;
       toWire(u, v, width, extension, wire);
       vRoutedWires.emplace_back(wire, u.z());
+      if (_bDeferCommit)
+        continue;
       _cir.addSpatialRoutedWire(_net.idx(), u.z(), wire);
       // add history cost
       _dr.addWireHistoryCost(_param.historyCost, u.z(), wire);
@@ -561,6 +947,7 @@ void DrGridAstar::savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>&
         Box<Int_t> symWire(wire);
         symWire.flipX(_net.symAxisX());
         _cir.addSpatialRoutedWire(_net.symNetIdx(), u.z(), symWire);
+        _shapeCache.invalidate(u.z(), symWire);
         _dr.addWireHistoryCost(_param.historyCost, u.z(), symWire);
       }
       if (_bSelfSym) {
@@ -638,6 +1025,8 @@ void DrGridAstar::savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>&
       //const LefVia& via = _cir.lef().via(botLayerIdx, 1, 1, botType, topType);
       const LefVia& via = _cir.lef().via(botLayerIdx, _param.numCutsRow, _param.numCutsCol, botViaWidth, botViaHeight, topViaWidth, topViaHeight);
       via2LayerBoxes(x, y, via, vRoutedWires);     
+      if (_bDeferCommit)
+        continue;
       _cir.addSpatialRoutedVia(_net.idx(), x, y, via);
       // add history cost
       _dr.addViaHistoryCost(_param.historyCost, x, y, via);
@@ -645,6 +1034,7 @@ void DrGridAstar::savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>&
       if (_bSym) {
         const Int_t symX = 2 * _net.symAxisX() - x;
         _cir.addSpatialRoutedVia(_net.symNetIdx(), symX, y, via);
+        invalidateShapeCache(symX, y, via);
         _dr.addViaHistoryCost(_param.historyCost, symX, y, via);
       }
       if (_bSelfSym) {
@@ -654,9 +1044,16 @@ void DrGridAstar::savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>&
       }
     }
   }
+  // the shapes are not in the database yet, keep their history cost locally
+  if (_bDeferCommit) {
+    for (const auto& pair : vRoutedWires) {
+      _vPendingHistoryMaps[pair.second].insert(pair.first, _param.historyCost);
+    }
+  }
 }
 
-void DrGridAstar::via2LayerBoxes(const Int_t x, const Int_t y, const LefVia& via, Vector_t<Pair_t<Box<Int_t>, Int_t>>& vLayerBoxes) {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::via2LayerBoxes(const Int_t x, const Int_t y, const LefVia& via, Vector_t<Pair_t<Box<Int_t>, Int_t>>& vLayerBoxes) {
   for (auto box : via.vBotBoxes()) {
     box.shift(x, y);
     vLayerBoxes.emplace_back(box, via.botLayerIdx());
@@ -671,15 +1068,26 @@ void DrGridAstar::via2LayerBoxes(const Int_t x, const Int_t y, const LefVia& via
   }
 }
 
-void DrGridAstar::addAcsPts(const Int_t idx, const Int_t z, const Box<Int_t>& box) {
-  Vector_t<Point3d<Int_t>> vAcs;
-  AcsMgr acs(_cir);
-  acs.computeBoxAcs(box, z, vAcs);
-  _vCompAcsPts[idx].insert(vAcs.begin(), vAcs.end());
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::addAcsPts(const Int_t idx, const Int_t z, const Box<Int_t>& box) {
+  // the grid points inside box, same rounding as AcsMgr::computeBoxAcs
+  const Int_t step = _cir.gridStep();
+  const Int_t lowerGridIdxX = (box.xl() - _cir.gridOffsetX() + step - 1) / step; // round up
+  const Int_t lowerGridIdxY = (box.yl() - _cir.gridOffsetY() + step - 1) / step; // round up
+  const Int_t higherGridIdxX = (box.xh() - _cir.gridOffsetX()) / step; // round down
+  const Int_t higherGridIdxY = (box.yh() - _cir.gridOffsetY()) / step; // round down
+  if (lowerGridIdxX > higherGridIdxX or lowerGridIdxY > higherGridIdxY)
+    return;
+  _vCompAcsBoxes[idx].emplace_back(Box<Int_t>(lowerGridIdxX * step + _cir.gridOffsetX(),
+                                              lowerGridIdxY * step + _cir.gridOffsetY(),
+                                              higherGridIdxX * step + _cir.gridOffsetX(),
+                                              higherGridIdxY * step + _cir.gridOffsetY()),
+                                   z);
 }
 
-void DrGridAstar::findNeighbors(DrGridAstarNode* pU) {
-  Vector_t<DrGridAstarNode*> vpNeighbors;
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::findNeighbors(const DrGridAstarNode* pU, DrGridAstarNodeArena& arena, Vector_t<DrGridAstarNode*>& vpNeighbors) {
+  vpNeighbors.clear();
   const auto& p = pU->coord();
   assert(p != Point3d<Int_t>(0, 0, 0));
   assert(_cir.lef().bRoutingLayer(p.z()));
@@ -693,14 +1101,9 @@ void DrGridAstar::findNeighbors(DrGridAstarNode* pU) {
                                  //_cir.lef().routingLayerIdx2LayerIdx(5) :
                                  //_cir.lef().routingLayerIdx2LayerIdx(0);
   if (p.z() > minLowerLayerIdx) {
-    const Point<Int_t> p2d(p.x(), p.y());
     const Int_t layerIdx = p.z() - 2;
     if (layerIdx >= 0 and _cir.lef().bRoutingLayer(layerIdx)) {
-      // add new node if not visited before
-      if (_vAllNodesMap[layerIdx].find(p2d) == _vAllNodesMap[layerIdx].end()) {
-        _vAllNodesMap[layerIdx][p2d] = new DrGridAstarNode(Point3d<Int_t>(p.x(), p.y(), layerIdx));
-      }
-      pU->addNeighbor(_vAllNodesMap[layerIdx][p2d]);
+      vpNeighbors.emplace_back(arena.node(Point3d<Int_t>(p.x(), p.y(), layerIdx)));
     }
   }
   // find upper layer neighbor
@@ -709,59 +1112,43 @@ void DrGridAstar::findNeighbors(DrGridAstarNode* pU) {
                                  _cir.lef().routingLayerIdx2LayerIdx(5) : // M6
                                  _cir.lef().routingLayerIdx2LayerIdx(4); // M5
   if (p.z() < maxUpperLayerIdx) { 
-    const Point<Int_t> p2d(p.x(), p.y());
     const Int_t layerIdx = p.z() + 2;
     if (_cir.lef().bRoutingLayer(layerIdx)) {
-      // add new node if not visited before
-      if (_vAllNodesMap[layerIdx].find(p2d) == _vAllNodesMap[layerIdx].end()) {
-        _vAllNodesMap[layerIdx][p2d] = new DrGridAstarNode(Point3d<Int_t>(p.x(), p.y(), layerIdx));
-      }
-      pU->addNeighbor(_vAllNodesMap[layerIdx][p2d]);
+      vpNeighbors.emplace_back(arena.node(Point3d<Int_t>(p.x(), p.y(), layerIdx)));
     }
   }
   // find left neighbor
-  if (p.x() > _cir.xl()) {
+  if (p.x() > _searchWindow.xl()) {
     const Int_t layerIdx = p.z();
     const Int_t newX = p.x() - step;
     const Point<Int_t> neighborP(newX, p.y());
-    if (_vAllNodesMap[layerIdx].find(neighborP) == _vAllNodesMap[layerIdx].end()) {
-      _vAllNodesMap[layerIdx][neighborP] = new DrGridAstarNode(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx));
-    }
-    pU->addNeighbor(_vAllNodesMap[layerIdx][neighborP]);
+    vpNeighbors.emplace_back(arena.node(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx)));
   }
   // find right neighbor
-  if (p.x() < _cir.xh()) {
+  if (p.x() < _searchWindow.xh()) {
     const Int_t layerIdx = p.z();
     const Int_t newX = p.x() + step;
     const Point<Int_t> neighborP(newX, p.y());
-    if (_vAllNodesMap[layerIdx].find(neighborP) == _vAllNodesMap[layerIdx].end()) {
-      _vAllNodesMap[layerIdx][neighborP] = new DrGridAstarNode(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx));
-    }
-    pU->addNeighbor(_vAllNodesMap[layerIdx][neighborP]);
+    vpNeighbors.emplace_back(arena.node(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx)));
   }
   // find down neighbor
-  if (p.y() > _cir.yl()) {
+  if (p.y() > _searchWindow.yl()) {
     const Int_t layerIdx = p.z();
     const Int_t newY = p.y() - step;
     const Point<Int_t> neighborP(p.x(), newY);
-    if (_vAllNodesMap[layerIdx].find(neighborP) == _vAllNodesMap[layerIdx].end()) {
-      _vAllNodesMap[layerIdx][neighborP] = new DrGridAstarNode(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx));
-    }
-    pU->addNeighbor(_vAllNodesMap[layerIdx][neighborP]);
+    vpNeighbors.emplace_back(arena.node(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx)));
   }
   // find up neighbor
-  if (p.y() < _cir.yh()) {
+  if (p.y() < _searchWindow.yh()) {
     const Int_t layerIdx = p.z();
     const Int_t newY = p.y() + step;
     const Point<Int_t> neighborP(p.x(), newY);
-    if (_vAllNodesMap[layerIdx].find(neighborP) == _vAllNodesMap[layerIdx].end()) {
-      _vAllNodesMap[layerIdx][neighborP] = new DrGridAstarNode(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx));
-    }
-    pU->addNeighbor(_vAllNodesMap[layerIdx][neighborP]);
+    vpNeighbors.emplace_back(arena.node(Point3d<Int_t>(neighborP.x(), neighborP.y(), layerIdx)));
   }
 }
 
-bool DrGridAstar::bViolateDRC(const DrGridAstarNode* pU, const DrGridAstarNode* pV, const Int_t srcIdx, const Int_t tarIdx) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bViolateDRC(const DrGridAstarNode* pU, const DrGridAstarNode* pV, const Int_t srcIdx, const Int_t tarIdx, const bool bReverse) {
   const auto& u = pU->coord();
   const auto& v = pV->coord();
   if (u.z() == v.z()) {
@@ -780,19 +1167,22 @@ bool DrGridAstar::bViolateDRC(const DrGridAstarNode* pU, const DrGridAstarNode*
     Box<Int_t> wire;
 
     toWire(u, v, width, extension, wire);
+    // nothing around, skip the exact checks
+    if (bCoverRasterClean(z, wire))
+      return false;
     // check DRC
-    if (!_drc.checkWireRoutingLayerSpacing(_net.idx(), z, wire))
+    if (!checkWireSpacing(z, wire))
       return true;
-    if (!_drc.checkWireEolSpacing(_net.idx(), z, wire))
+    if (!drc().checkWireEolSpacing(_net.idx(), z, wire))
       return true;
    
     // check symmetric DRC
     if (_bSym) {
       Box<Int_t> symWire(wire);
       symWire.flipX(_net.symAxisX());
-      if (!_drc.checkWireRoutingLayerSpacing(_net.symNetIdx(), z, symWire))
+      if (!drc().checkWireRoutingLayerSpacing(_net.symNetIdx(), z, symWire))
         return true;
-      if (!_drc.checkWireEolSpacing(_net.symNetIdx(), z, symWire))
+      if (!drc().checkWireEolSpacing(_net.symNetIdx(), z, symWire))
         return true;
     }
     
@@ -801,9 +1191,9 @@ bool DrGridAstar::bViolateDRC(const DrGridAstarNode* pU, const DrGridAstarNode*
     {
       Box<Int_t> symWire(wire);
       symWire.flipX(_net.symAxisX());
-      if (!_drc.checkWireRoutingLayerSpacing(_net.idx(), z, symWire))
+      if (!checkWireSpacing(z, symWire))
         return true;
-      if (!_drc.checkWireEolSpacing(_net.idx(), z, symWire))
+      if (!drc().checkWireEolSpacing(_net.idx(), z, symWire))
         return true;
     }
   }
@@ -814,51 +1204,208 @@ bool DrGridAstar::bViolateDRC(const DrGridAstarNode* pU, const DrGridAstarNode*
     const Int_t y = u.y();
     const Int_t botLayerIdx = std::min(u.z(), v.z());
     const LefVia& via = _cir.lef().via(botLayerIdx, _param.numCutsRow, _param.numCutsCol);
-    if (!_drc.checkViaSpacing(_net.idx(), x, y, via))
+    const bool bClean = bCoverRasterClean(x, y, via);
+    if (!bClean and !checkViaSpacing(x, y, via))
       return true;
     // TODO: minarea, minstep
     // check min area
-    if (!checkMinArea(pU, pV))
+    if (!checkMinArea(pU, pV, bReverse))
       return true;
+    if (bClean)
+      return false;
     
     if (_bSym) {
       const Int_t symX = 2 * _net.symAxisX() - x;
-      if (!_drc.checkViaSpacing(_net.symNetIdx(), symX, y, via))
+      if (!drc().checkViaSpacing(_net.symNetIdx(), symX, y, via))
         return true;
     }
     if (_bSelfSym) {
       const Int_t symX = 2 * _net.symAxisX() - x;
-      if (!_drc.checkViaSpacing(_net.idx(), symX, y, via))
+      if (!checkViaSpacing(symX, y, via))
         return true;
     }
   }
   return false;
 }
 
-bool DrGridAstar::checkMinArea(const DrGridAstarNode* pU, const DrGridAstarNode* pV) {
+// the shapes DrcMgr reports as spacing violations of this net, around the window;
+// tiles are loaded on first use and kept for all subnets and window growths of this run
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::initShapeCache() {
+  Box<Int_t> bound(_window);
+  bound.expand(_param.shapeCacheMargin * _cir.gridStep());
+  for (const auto& acsBoxes : _vCompAcsBoxes) {
+    for (const auto& pair : acsBoxes) {
+      bound.coverPoint(pair.first.min_corner());
+      bound.coverPoint(pair.first.max_corner());
+    }
+  }
+  _shapeCache.init(_cir.lef().numLayers(), bound, _param.shapeCacheTileSize * _cir.gridStep());
+}
+
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::loadShapes(const Int_t layerIdx, const Box<Int_t>& tileBox, Vector_t<Box<Int_t>>& vBoxes) {
+  // pins and blks only count in routing layers
+  if (_cir.lef().bRoutingLayer(layerIdx)) {
+    _cir.vSpatialPins()[layerIdx].visit(tileBox, [&] (const Box<Int_t>& box, const UInt_t pinIdx) {
+      if (_cir.pin(pinIdx).netIdx() != _net.idx())
+        vBoxes.emplace_back(box);
+    });
+    _cir.vSpatialBlks()[layerIdx].visit(tileBox, [&] (const Box<Int_t>& box, const UInt_t blkIdx) {
+      const Blk& blk = _cir.blk(blkIdx);
+      if (blk.pinIdx() == MAX_UINT or _cir.pin(blk.pinIdx()).netIdx() != _net.idx())
+        vBoxes.emplace_back(box);
+    });
+  }
+  else if (!_cir.lef().bCutLayer(layerIdx)) {
+    return;
+  }
+  auto addWire = [&] (const Box<Int_t>& wire, const UInt_t netIdx) {
+    if (netIdx != _net.idx())
+      vBoxes.emplace_back(wire);
+  };
+  if (_pRoutedWires)
+    _pRoutedWires->layer(layerIdx).visit(tileBox, addWire);
+  else
+    _cir.visitSpatialRoutedWire(layerIdx, tileBox, addWire);
+}
+
+// the symmetric net's shapes changed under the cache
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::invalidateShapeCache(const Int_t x, const Int_t y, const LefVia& via) {
+  Vector_t<Pair_t<Box<Int_t>, Int_t>> vLayerBoxes;
+  via2LayerBoxes(x, y, via, vLayerBoxes);
+  for (const auto& pair : vLayerBoxes) {
+    _shapeCache.invalidate(pair.second, pair.first);
+  }
+}
+
+// same as DrcMgr::checkWireRoutingLayerSpacing / checkWireCutLayerSpacing for this net,
+// answered by the shape cache unless the check box leaves it
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::checkWireSpacing(const Int_t z, const Box<Int_t>& box) {
+  const bool bRoutingLayer = _cir.lef().bRoutingLayer(z);
+  const Int_t spacing = bRoutingLayer ?
+                        _cir.lef().prlSpacing(z, std::min(box.width(), box.height())) :
+                        _cir.lef().cutLayer(_cir.lef().layerPair(z).second).spacing();
+  Box<Int_t> checkBox(box);
+  checkBox.expand(spacing - 1);
+  if (_shapeCache.bCover(checkBox)) {
+    return !_shapeCache.bOverlap(z, checkBox, [this] (const Int_t layerIdx, const Box<Int_t>& tileBox, Vector_t<Box<Int_t>>& vBoxes) {
+      loadShapes(layerIdx, tileBox, vBoxes);
+    });
+  }
+  return bRoutingLayer ? drc().checkWireRoutingLayerSpacing(_net.idx(), z, box)
+                       : drc().checkWireCutLayerSpacing(_net.idx(), z, box);
+}
+
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::checkViaSpacing(const Int_t x, const Int_t y, const LefVia& via) {
+  for (auto box : via.vBotBoxes()) {
+    box.shift(x, y);
+    if (!checkWireSpacing(via.botLayerIdx(), box))
+      return false;
+  }
+  for (auto box : via.vCutBoxes()) {
+    box.shift(x, y);
+    if (!checkWireSpacing(via.cutLayerIdx(), box))
+      return false;
+  }
+  for (auto box : via.vTopBoxes()) {
+    box.shift(x, y);
+    if (!checkWireSpacing(via.topLayerIdx(), box))
+      return false;
+  }
+  return true;
+}
+
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bCoverClean(const Int_t z, const Box<Int_t>& box) const {
+  return _pRoutedWires ? _pRoutedWires->coverRaster().bClean(z, box) : _cir.bCoverRasterClean(z, box);
+}
+
+// true if the wire or via (and its mirror) is clear of every shape on the cover raster,
+// then no spacing check can fail
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bCoverRasterClean(const Int_t z, const Box<Int_t>& wire) {
+  if (!bCoverClean(z, wire))
+    return false;
+  if (_bSym or _bSelfSym) {
+    Box<Int_t> symWire(wire);
+    symWire.flipX(_net.symAxisX());
+    if (!bCoverClean(z, symWire))
+      return false;
+  }
+  return true;
+}
+
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bCoverRasterClean(const Int_t x, const Int_t y, const LefVia& via) {
+  auto bClean = [&] (const Int_t viaX) {
+    for (auto box : via.vBotBoxes()) {
+      box.shift(viaX, y);
+      if (!bCoverClean(via.botLayerIdx(), box))
+        return false;
+    }
+    for (auto box : via.vCutBoxes()) {
+      box.shift(viaX, y);
+      if (!bCoverClean(via.cutLayerIdx(), box))
+        return false;
+    }
+    for (auto box : via.vTopBoxes()) {
+      box.shift(viaX, y);
+      if (!bCoverClean(via.topLayerIdx(), box))
+        return false;
+    }
+    return true;
+  };
+  if (!bClean(x))
+    return false;
+  if (_bSym or _bSelfSym)
+    return bClean(2 * _net.symAxisX() - x);
+  return true;
+}
+
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::checkMinArea(const DrGridAstarNode* pU, const DrGridAstarNode* pV, const bool bReverse) {
+  // the same-layer wire ending at pU is tracked by updateRun()
+  if (pU->runArea() == 0)
+    return true;
+  // walking toward tar, the wire may still be extended unless it ends in a via
+  if (bReverse and !pU->bRunFromVia())
+    return true;
   const Int_t layerIdx = pU->coord().z();
-  const DrGridAstarNode* pN = pU;
-  Vector_t<Box<Int_t>> vPrePath;
-  // get the layer information
-  //assert(_cir.lef().bRoutingLayer(layerIdx));
-  //const auto& layerPair = _cir.lef().layerPair(layerIdx);
-  //const auto& layer = _cir.lef().routingLayer(layerPair.second);
-  //const Int_t width = layer.minWidth();
+  assert(_cir.lef().bRoutingLayer(layerIdx));
+  const auto& layerPair = _cir.lef().layerPair(layerIdx);
+  const auto& layer = _cir.lef().routingLayer(layerPair.second);
+  return pU->runArea() >= layer.minArea();
+}
+
+// extend the same-layer wire of the parent by one edge,
+// the area is the one DrcMgr::checkWireMinArea computes for the wire boxes
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::updateRun(DrGridAstarNode* pV) {
+  const DrGridAstarNode* pU = pV->pParent();
+  if (pU->coord().z() != pV->coord().z()) {
+    pV->setRun(0, false);
+    return;
+  }
   const Int_t width = _net.minWidth();
   const Int_t extension = width / 2;
-
-  while (pN->pParent() and pN->pParent()->coord().z() == layerIdx) {
-    // generate the exact wire shape
-    Box<Int_t> wire;
-    toWire(pN->coord(), pN->pParent()->coord(), width, extension, wire);
-    vPrePath.emplace_back(wire);
-    pN = pN->pParent();
+  Box<Int_t> wire;
+  toWire(pV->coord(), pU->coord(), width, extension, wire);
+  const DrGridAstarNode* pP = pU->pParent();
+  if (pU->runArea() == 0) {
+    pV->setRun(wire.area(), pP != nullptr);
+    return;
   }
-  assert(layerIdx == pN->coord().z());
-  return _drc.checkWireMinArea(layerIdx, vPrePath);
+  Box<Int_t> preWire;
+  toWire(pU->coord(), pP->coord(), width, extension, preWire);
+  pV->setRun(pU->runArea() + wire.area() - Box<Int_t>::overlapArea(wire, preWire), pU->bRunFromVia());
 }
 
-bool DrGridAstar::bNeedUpdate(const DrGridAstarNode* pV, const Int_t costG, const Int_t bendCnt) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bNeedUpdate(const DrGridAstarNode* pV, const Int_t costG, const Int_t bendCnt) {
   if (pV->costG() > costG)
     return true;
   else if (pV->bendCnt() > bendCnt)
@@ -866,16 +1413,20 @@ bool DrGridAstar::bNeedUpdate(const DrGridAstarNode* pV, const Int_t costG, cons
   return false;
 }
 
-void DrGridAstar::resetAllNodes() {
-  for (auto& map : _vAllNodesMap) {
-    for (auto& pair : map) {
-      DrGridAstarNode* pNode = pair.second;
-      pNode->reset();
-    }
-  }
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::resetAllNodes() {
+  _nodeArena.resetAllNodes();
+  _revNodeArena.resetAllNodes();
 }
 
-void DrGridAstar::saveResult2Net() {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::saveResult2Net() {
+  if (!_bSym and !_bSelfSym) {
+    auto& vSubNetPaths = _dr._vvNetRoutedPaths[_net.idx()];
+    for (Int_t i = 0; i < (Int_t)_vvRoutePaths.size(); ++i) {
+      vSubNetPaths.push_back({_vvRoutePaths[i], _vvRoutedWires[i]});
+    }
+  }
   for (const auto& vRoutePath : _vvRoutePaths) {
     for (const auto& pair : vRoutePath) {
       _ro.vPathIndices().emplace_back(_net.vRoutePaths().size());
@@ -955,7 +1506,8 @@ void DrGridAstar::saveResult2Net() {
   }
 }
 
-void DrGridAstar::ripup() {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::ripup() {
   for (const auto& vRoutedWires : _vvRoutedWires) {
     for (const auto& pair : vRoutedWires) {
       const Box<Int_t>& wire = pair.first;
@@ -967,6 +1519,7 @@ void DrGridAstar::ripup() {
         symWire.flipX(_net.symAxisX());
         bool bExist = _cir.removeSpatialRoutedWire(_net.symNetIdx(), layerIdx, symWire);
         assert(bExist);
+        _shapeCache.invalidate(layerIdx, symWire);
       }
       if (_bSelfSym)
       {
@@ -979,7 +1532,8 @@ void DrGridAstar::ripup() {
   }
 }
 
-Int_t DrGridAstar::scaledMDist(const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
+template <typename CostPolicy>
+Int_t DrGridAstarKernel<CostPolicy>::scaledMDist(const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
   Int_t dist = 0;
   dist += abs(u.x() - v.x()) * _param.horCost;
   dist += abs(u.y() - v.y()) * _param.verCost;
@@ -987,14 +1541,16 @@ Int_t DrGridAstar::scaledMDist(const Point3d<Int_t>& u, const Point3d<Int_t>& v)
   return dist;
 }
 
-Int_t DrGridAstar::scaledMDist(const Box<Int_t>& u, const Box<Int_t>& v) {
+template <typename CostPolicy>
+Int_t DrGridAstarKernel<CostPolicy>::scaledMDist(const Box<Int_t>& u, const Box<Int_t>& v) {
   Int_t dist = 0;
   dist += std::max({u.bl().x() - v.tr().x(), v.bl().x() - u.tr().x(), (Int_t)0}) * _param.horCost;
   dist += std::max({u.bl().y() - v.tr().y(), v.bl().y() - u.tr().y(), (Int_t)0}) * _param.verCost;
   return dist;
 }
 
-Int_t DrGridAstar::scaledMDist(const Point3d<Int_t>& u, const Pair_t<Box<Int_t>, Int_t>& pair) {
+template <typename CostPolicy>
+Int_t DrGridAstarKernel<CostPolicy>::scaledMDist(const Point3d<Int_t>& u, const Pair_t<Box<Int_t>, Int_t>& pair) {
   Int_t dx = 0, dy = 0, dz = 0;
   const Box<Int_t>& box = pair.first;
   if (u.x() < box.xl())
@@ -1011,20 +1567,23 @@ Int_t DrGridAstar::scaledMDist(const Point3d<Int_t>& u, const Pair_t<Box<Int_t>,
          dz * _param.viaCost;
 }
 
-Int_t DrGridAstar::scaledMDist(const Pair_t<Box<Int_t>, Int_t>& u, const Pair_t<Box<Int_t>, Int_t>& v) {
+template <typename CostPolicy>
+Int_t DrGridAstarKernel<CostPolicy>::scaledMDist(const Pair_t<Box<Int_t>, Int_t>& u, const Pair_t<Box<Int_t>, Int_t>& v) {
   Int_t dist = scaledMDist(u.first, v.first);
   dist += abs(u.second - v.second) * _param.viaCost;
   return dist;
 }
 
-bool DrGridAstar::hasBend(const DrGridAstarNode* pU, const DrGridAstarNode* pV) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::hasBend(const DrGridAstarNode* pU, const DrGridAstarNode* pV) {
   if (pU->pParent() != nullptr) {
     return findDir(pU->pParent()->coord(), pU->coord()) != findDir(pU->coord(), pV->coord());
   }
   return false;
 }
 
-DrGridAstar::PathDir DrGridAstar::findDir(const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
+template <typename CostPolicy>
+typename DrGridAstarKernel<CostPolicy>::PathDir DrGridAstarKernel<CostPolicy>::findDir(const Point3d<Int_t>& u, const Point3d<Int_t>& v) {
   if (u.z() == v.z()) {
     if (u.x() == v.x()) {
       assert(u.y() != v.y());
@@ -1041,22 +1600,27 @@ DrGridAstar::PathDir DrGridAstar::findDir(const Point3d<Int_t>& u, const Point3d
   }
 }
 
-bool DrGridAstar::bInsideGuide(const DrGridAstarNode* pU) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bInsideGuide(const DrGridAstarNode* pU) {
   const auto& u = pU->coord();
   assert(u.z() < (Int_t)_cir.vSpatialNetGuides(_net.idx()).size() and u.z() > 0);
-  const Point<Int_t> u2d(u.x(), u.y());
-  return _cir.vSpatialNetGuides(_net.idx())[u.z()].exist(u2d, u2d);
+  return _cir.bInsideNetGuide(_net.idx(), u.z(), u.x(), u.y());
 }
 
-Int_t DrGridAstar::history(const DrGridAstarNode* pU) {
+template <typename CostPolicy>
+Int_t DrGridAstarKernel<CostPolicy>::history(const DrGridAstarNode* pU) {
   const auto& u = pU->coord();
-  const Point<Int_t> u2d(u.x(), u.y());
-  Vector_t<Int_t> vHis;
-  _dr._vSpatialHistoryMaps[u.z()].query(u2d, u2d, vHis);
-  return std::accumulate(vHis.begin(), vHis.end(), 0);
+  Int_t pendingCost = 0;
+  if (_bDeferCommit) {
+    _vPendingHistoryMaps[u.z()].visit(Box<Int_t>(u.x(), u.y(), u.x(), u.y()), [&] (const Box<Int_t>& box, const Int_t cost) {
+      pendingCost += cost;
+    });
+  }
+  return pendingCost + _dr._historyGrid.cost(u.z(), u.x(), u.y());
 }
 
-void DrGridAstar::toWire(const Point3d<Int_t>& u, const Point3d<Int_t>& v, const Int_t width, const Int_t extension, Box<Int_t>& wire) {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::toWire(const Point3d<Int_t>& u, const Point3d<Int_t>& v, const Int_t width, const Int_t extension, Box<Int_t>& wire) {
   // change wire width here
   assert(u.z() == v.z());
   const Int_t halfWidth = width / 2;
@@ -1079,7 +1643,8 @@ void DrGridAstar::toWire(const Point3d<Int_t>& u, const Point3d<Int_t>& v, const
   wire.setYH(yh);
 }
 
-AcsPt::DirType DrGridAstar::findAcsDir(const DrGridAstarNode* pU) {
+template <typename CostPolicy>
+AcsPt::DirType DrGridAstarKernel<CostPolicy>::findAcsDir(const DrGridAstarNode* pU) {
   assert(pU->pParent() != nullptr);
   switch (findDir(pU->coord(), pU->pParent()->coord())) {
     case PathDir::LEFT: return AcsPt::DirType::WEST;
@@ -1092,7 +1657,8 @@ AcsPt::DirType DrGridAstar::findAcsDir(const DrGridAstarNode* pU) {
   }
 }
 
-void DrGridAstar::connect2AcsPt(const DrGridAstarNode* pU) {
+template <typename CostPolicy>
+void DrGridAstarKernel<CostPolicy>::connect2AcsPt(const DrGridAstarNode* pU) {
   _vvRoutedWires.resize(_vvRoutedWires.size() + 1);
   const auto& pt = pU->coord();
   const auto& acsPt = _pinAcsMap.at(pt).gridPt();
@@ -1112,6 +1678,7 @@ void DrGridAstar::connect2AcsPt(const DrGridAstarNode* pU) {
     Box<Int_t> symWire(wire);
     symWire.flipX(_net.symAxisX());
     _cir.addSpatialRoutedWire(_net.symNetIdx(), pt.z(), symWire);
+    _shapeCache.invalidate(pt.z(), symWire);
   }
   if (_bSelfSym) {
     Box<Int_t> symWire(wire);
@@ -1120,7 +1687,8 @@ void DrGridAstar::connect2AcsPt(const DrGridAstarNode* pU) {
   }
 }
 
-bool DrGridAstar::bStackedVia(const DrGridAstarNode* pU, const DrGridAstarNode* pV) {
+template <typename CostPolicy>
+bool DrGridAstarKernel<CostPolicy>::bStackedVia(const DrGridAstarNode* pU, const DrGridAstarNode* pV) {
   if (pU->coord().z() != pV->coord().z()) {
     assert(pU->coord().x() == pV->coord().x()
            and pU->coord().y() == pV->coord().y());
@@ -1133,4 +1701,9 @@ bool DrGridAstar::bStackedVia(const DrGridAstarNode* pU, const DrGridAstarNode*
   return false;
 }
 
+// the kernels used by DrGridRoute
+template class DrGridAstarKernel<DrGridCost>;
+template class DrGridAstarKernel<PADrGridCost>;
+template class DrGridAstarKernel<GnDrGridCost>;
+
 PROJECT_NAMESPACE_END
@@ -11,45 +11,70 @@
 
 #include "drGridRoute.hpp"
 #include "drGridAstarNode.hpp"
+#include "drGridAstarCost.hpp"
 #include "src/ds/disjointSet.hpp"
-#include "src/ds/hash.hpp"
 #include "src/geo/point3d.hpp"
+#include "src/geo/shapeCache.hpp"
 #include "src/geo/spatial.hpp"
 
+#include <atomic>
+#include <memory>
+
 PROJECT_NAMESPACE_START
 
-class DrGridAstar {
+// One kernel for all grid-based detailed routers, the cost terms that
+// differ between them come from CostPolicy (see drGridAstarCost.hpp)
+template <typename CostPolicy>
+class DrGridAstarKernel {
  public:
-  DrGridAstar(CirDB& c, Net& n, Routable& ro, DrcMgr& d, DrGridRoute& dr,
-              const bool bSym, const bool bSelfSym, const bool bStrictDRC)
+  DrGridAstarKernel(CirDB& c, Net& n, Routable& ro, DrcMgr& d, DrGridRoute& dr,
+                    const bool bSym, const bool bSelfSym, const bool bStrictDRC)
     : _cir(c), _net(n), _ro(ro), _drc(d), _dr(dr),
-      _bSym(bSym), _bSelfSym(bSelfSym), _bStrictDRC(bStrictDRC)
+      _bSym(bSym), _bSelfSym(bSelfSym), _bStrictDRC(bStrictDRC),
+      _window(c.xl(), c.yl(), c.xh(), c.yh()),
+      _cost(c, n)
   {
-    _param.numCutsRow = _net.bPower() ? _param.numPowerCutsRow : _param.numSignalCutsRow;
-    _param.numCutsCol = _net.bPower() ? _param.numPowerCutsCol : _param.numSignalCutsCol;
-    if (_net.numCutsRow() and _net.numCutsCol()) {
-      _param.numCutsRow = _net.numCutsRow();
-      _param.numCutsCol = _net.numCutsCol();
-    }
-    
+    numCuts(_net, _param.numCutsRow, _param.numCutsCol);
     assert(_param.numCutsRow * _param.numCutsCol >= _net.minCuts());
 
-    _vAllNodesMap.resize(_cir.lef().numLayers());
-    for (auto& m : _vAllNodesMap) {
-      m.set_empty_key(Point<Int_t>(-1, -1));
-    }
     _param.viaCost = _cir.gridStep() * 3;
+    _param.bBoxHeuristic = dr._param.bBoxHeuristic;
+    _param.bBidirectional = dr._param.bBidirectional;
+    _cost.adjust(_param.horCost, _param.verCost, _param.viaCost);
   }
-  
-  ~DrGridAstar() {
-    for (auto& v : _vAllNodesMap) {
-      for (auto& m : v) {
-        delete m.second;
-      }
+
+  ~DrGridAstarKernel() {}
+
+  // the via cut array of the net: its spec, or the default of its kind
+  static void numCuts(const Net& net, Int_t& numCutsRow, Int_t& numCutsCol) {
+    Param param;
+    numCutsRow = net.bPower() ? param.numPowerCutsRow : param.numSignalCutsRow;
+    numCutsCol = net.bPower() ? param.numPowerCutsCol : param.numSignalCutsCol;
+    if (net.numCutsRow() and net.numCutsCol()) {
+      numCutsRow = net.numCutsRow();
+      numCutsCol = net.numCutsCol();
     }
   }
 
   bool run();
+  // restrict the search to a sub-region of the die (parallel routing)
+  void setWindow(const Box<Int_t>& w) { _window = w; }
+  // keep the result private until commit() (portfolio routing)
+  void setDeferCommit(const bool b) {
+    assert(!b or (!_bSym and !_bSelfSym));
+    _bDeferCommit = b;
+    _vPendingHistoryMaps.resize(b ? _cir.lef().numLayers() : 0);
+  }
+  // read routed wires from a snapshot instead of the live state, so the
+  // search sees whole committed nets only (optimistic routing)
+  void setRoutedWireSnapshot(const RoutedWireStore::SnapshotPtr& p) {
+    _pRoutedWires = p;
+    _pSnapshotDrc.reset(p ? new DrcMgr(_cir, p) : nullptr);
+  }
+  // stop searching once the flag is raised
+  void setCancelFlag(const std::atomic<bool>* p) { _pbCancel = p; }
+  void commit();
+  const Vector_t<Vector_t<Pair_t<Box<Int_t>, Int_t>>>& vvRoutedWires() const { return _vvRoutedWires; }
 
  private:
   CirDB&        _cir;
@@ -60,11 +85,21 @@ class DrGridAstar {
   const bool    _bSym;
   const bool    _bSelfSym;
   const bool    _bStrictDRC;
+  Box<Int_t>    _window;
+  Box<Int_t>    _searchWindow;    // part of _window the current path search may use
+  Int_t         _searchBudget = 0; // open list size limit of the current path search
+  ShapeCache    _shapeCache;      // other nets' shapes around _window
+  bool          _bDeferCommit = false;
+  RoutedWireStore::SnapshotPtr _pRoutedWires; // null: the live routed wires
+  std::unique_ptr<DrcMgr> _pSnapshotDrc; // checks against _pRoutedWires
+  const std::atomic<bool>* _pbCancel = nullptr;
+  Vector_t<SpatialMap<Int_t, Int_t>> _vPendingHistoryMaps; // history of the uncommitted result
+  CostPolicy    _cost;
 
   // components
   DisjointSet                                                     _compDS;
   Vector_t<Vector_t<Pair_t<Box<Int_t>, Int_t>>>                   _vCompBoxes;
-  Vector_t<DenseHashSet<Point3d<Int_t>, Point3d<Int_t>::hasher>>  _vCompAcsPts;
+  Vector_t<List_t<Pair_t<Box<Int_t>, Int_t>>>                     _vCompAcsBoxes; // grid-snapped, each stands for the grid points inside
   Vector_t<UMap_t<Int_t, Spatial<Int_t>>>                         _vCompSpatialBoxes;
   Vector_t<Pair_t<Int_t, Int_t>>                                  _vSubNets;
   
@@ -76,8 +111,10 @@ class DrGridAstar {
   std::unordered_map<Point3d<Int_t>, AcsPt, Point3d<Int_t>::hasher> _pinAcsMap;
 
   // astar
-  // mem add in routeSubNet(), free in destructor
-  Vector_t<DenseHashMap<Point<Int_t>, DrGridAstarNode*, Point<Int_t>::hasher>> _vAllNodesMap;
+  // nodes over the window and the access points, built in run()
+  DrGridAstarNodeArena _nodeArena;
+  DrGridAstarNodeArena _revNodeArena; // backward search of bidirPathSearch()
+  Vector_t<DrGridAstarNode*> _vpNeighbors;
 
   // result
   Vector_t<Vector_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>>  _vvRoutePaths;
@@ -94,7 +131,15 @@ class DrGridAstar {
     Int_t stackedViaCost = 2000;
     Int_t drcCost = 20000;
     Int_t historyCost = 500; // the cost added to the history map
-    Int_t maxExplore = 90000;
+    Int_t maxExplore = 90000;  // upper bound of the open list size
+    Float_t exploreRatio = 0.25; // open list size limit per node in the search window
+    Int_t windowMargin = 10;     // initial search window margin around a subnet (grids)
+    Int_t windowGrowth = 2;      // margin multiplier of each retry
+    bool  bBoxHeuristic = false; // bound by the target bounding box instead of the nearest target point
+    bool  bBidirectional = false; // search from both components of a subnet
+    bool  bReusePath = true; // keep the subnet paths of the last routing that are still clean
+    Int_t shapeCacheMargin = 4;   // grids the shape cache extends beyond the window
+    Int_t shapeCacheTileSize = 8; // grids
     // electrical
     Int_t numCutsRow;
     Int_t numCutsCol;
@@ -104,6 +149,8 @@ class DrGridAstar {
     Int_t numPowerCutsCol = 3;
   } _param;
   
+  struct Heuristic;
+
   enum class PathDir : Byte_t {
     LEFT      = 0,
     RIGHT     = 1,
@@ -120,21 +167,42 @@ class DrGridAstar {
   void  initSelfSym();
   void  initFromRoutable(const Routable& ro);
   void  initSelfSymFromRoutable(const Routable& ro);
+  void  initNodeArena();
 
   void  splitSubNetMST();
   bool  route();
   bool  routeSubNet(Int_t srcIdx, Int_t tarIdx);
   bool  pathSearch(const Int_t srcIdx, const Int_t tarIdx);
+  bool  bidirPathSearch(const Int_t srcIdx, const Int_t tarIdx);
+  void  initFrontier(const List_t<Pair_t<Box<Int_t>, Int_t>>& src,
+                     DrGridAstarNodeArena& arena, Heuristic& costH, IndexedHeap<DrGridAstarNode>& pq);
+  void  expandNode(DrGridAstarNode* pU, DrGridAstarNodeArena& arena, Heuristic& costH,
+                   IndexedHeap<DrGridAstarNode>& pq, const bool bReverse, const Int_t srcIdx, const Int_t tarIdx);
+  bool  bCanMeet(const DrGridAstarNode* pF, const DrGridAstarNode* pB);
   Int_t mergeComp(const Int_t srcIdx, const Int_t tarIdx);
-  void  backTrack(const DrGridAstarNode* pU, const Int_t bigCompIdx, const Int_t srcIdx, const Int_t tarIdx);
+  void  backTrack(const DrGridAstarNode* pU, const Int_t bigCompIdx, const Int_t srcIdx, const Int_t tarIdx,
+                   const DrGridAstarNode* pRevU = nullptr);
+  void  addPath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec,
+                 const Int_t bigCompIdx, const Int_t srcIdx, const Int_t tarIdx);
+  bool  bReuseSubNetPath(const Int_t srcIdx, const Int_t tarIdx);
+  bool  bInsideComp(const Int_t compIdx, const Point3d<Int_t>& p);
   void  add2Path(const DrGridAstarNode* pU, List_t<Point3d<Int_t>>& lPathPts);
   void  mergePath(const List_t<Point3d<Int_t>>& lPathPts, List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec);
   bool  bNeedMergePath(const Point3d<Int_t>& u1, const Point3d<Int_t>& v1, const Point3d<Int_t>& u2, const Point3d<Int_t>& v2);
   void  addAcsPts(const Int_t idx, const Int_t z, const Box<Int_t>& box);
-  void  findNeighbors(DrGridAstarNode* pU);
-  bool  bFindAcsPt(const DrGridAstarNode* pU, const Int_t tarIdx);
-  bool  bViolateDRC(const DrGridAstarNode* pU, const DrGridAstarNode* pV, const Int_t srcIdx, const Int_t tarIdx);
-  bool  checkMinArea(const DrGridAstarNode* pU, const DrGridAstarNode* pV);
+  void  findNeighbors(const DrGridAstarNode* pU, DrGridAstarNodeArena& arena, Vector_t<DrGridAstarNode*>& vpNeighbors);
+  bool  bViolateDRC(const DrGridAstarNode* pU, const DrGridAstarNode* pV, const Int_t srcIdx, const Int_t tarIdx, const bool bReverse = false);
+  bool  checkMinArea(const DrGridAstarNode* pU, const DrGridAstarNode* pV, const bool bReverse = false);
+  void  updateRun(DrGridAstarNode* pV);
+  void  initShapeCache();
+  void  loadShapes(const Int_t layerIdx, const Box<Int_t>& tileBox, Vector_t<Box<Int_t>>& vBoxes);
+  void  invalidateShapeCache(const Int_t x, const Int_t y, const LefVia& via);
+  bool  checkWireSpacing(const Int_t z, const Box<Int_t>& box);
+  bool  checkViaSpacing(const Int_t x, const Int_t y, const LefVia& via);
+  const DrcMgr& drc() const { return _pSnapshotDrc ? *_pSnapshotDrc : _drc; }
+  bool  bCoverClean(const Int_t z, const Box<Int_t>& box) const;
+  bool  bCoverRasterClean(const Int_t z, const Box<Int_t>& wire);
+  bool  bCoverRasterClean(const Int_t x, const Int_t y, const LefVia& via);
   bool  bNeedUpdate(const DrGridAstarNode* pV, const Int_t costG, const Int_t bendCnt);
   void  resetAllNodes();
   void  savePath(const List_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>>& lPathVec);
@@ -154,10 +222,14 @@ class DrGridAstar {
   Int_t   history(const DrGridAstarNode* pU);
   void    toWire(const Point3d<Int_t>& u, const Point3d<Int_t>& v, const Int_t width, const Int_t extension, Box<Int_t>& wire);
   bool    bStackedVia(const DrGridAstarNode* pU, const DrGridAstarNode* pV);
+  bool    bCancelled() const { return _pbCancel and _pbCancel->load(std::memory_order_relaxed); }
 
   AcsPt::DirType findAcsDir(const DrGridAstarNode* pU);
 };
 
+using DrGridAstar   = DrGridAstarKernel<DrGridCost>;
+using PADrGridAstar = DrGridAstarKernel<PADrGridCost>;
+using gnDrGridAstar = DrGridAstarKernel<GnDrGridCost>;
 
 PROJECT_NAMESPACE_END
 
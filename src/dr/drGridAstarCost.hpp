@@ -0,0 +1,93 @@
+/**
+ * @file   drGridAstarCost.hpp
+ * @brief  Detailed Routing - Cost policies of the Grid-Based A* search kernel
+ *
+ **/
+
+#ifndef _DR_GRID_ASTAR_COST_HPP_
+#define _DR_GRID_ASTAR_COST_HPP_
+
+#include "drGridAstarNode.hpp"
+#include "src/db/dbCir.hpp"
+#include "src/util/Assert.h"
+
+PROJECT_NAMESPACE_START
+
+// A cost policy adjusts the unit costs of the kernel when it is constructed
+// and adds an extra cost to every relaxed edge. The kernel is instantiated
+// per policy, so the unused hooks compile away.
+
+// plain detailed routing
+class DrGridCost {
+ public:
+  DrGridCost(CirDB& c, Net& n) {}
+
+  static const char* name() { return "DrGridAstar"; }
+  void  adjust(Int_t& horCost, Int_t& verCost, Int_t& viaCost) const {}
+  Int_t edgeCost(const DrGridAstarNode* pU, const DrGridAstarNode* pV) const { return 0; }
+};
+
+// performance-driven: per-net horizontal, vertical and via guidance
+class PADrGridCost {
+ public:
+  PADrGridCost(CirDB& c, Net& n)
+    : _horGuide(c.horGuide(n)), _verGuide(c.verGuide(n)), _viaGuide(c.gridStep() * c.viaGuide(n)) {}
+
+  static const char* name() { return "PADrGridAstar"; }
+  void adjust(Int_t& horCost, Int_t& verCost, Int_t& viaCost) const {
+    horCost += _horGuide;
+    verCost += _verGuide;
+    viaCost += _viaGuide;
+  }
+  Int_t edgeCost(const DrGridAstarNode* pU, const DrGridAstarNode* pV) const { return 0; }
+
+ private:
+  Int_t _horGuide;
+  Int_t _verGuide;
+  Int_t _viaGuide;
+};
+
+// GeniusRoute: the average RouteGuide cost of the 64x64 cells a wire passes
+class GnDrGridCost {
+ public:
+  GnDrGridCost(CirDB& c, Net& n)
+    : _cir(c), _netIdx(n.idx()),
+      _scaleX((_cir.xh() - _cir.xl()) / 64), _scaleY((_cir.yh() - _cir.yl()) / 64) {}
+
+  static const char* name() { return "gnDrGridAstar"; }
+  void  adjust(Int_t& horCost, Int_t& verCost, Int_t& viaCost) const {}
+  Int_t edgeCost(const DrGridAstarNode* pU, const DrGridAstarNode* pV) const {
+    Int_t cost = 0;
+    Int_t count = 0;
+    if (pU->coord().z() != pV->coord().z()) {
+      Assert(pU->coord().x() == pV->coord().x());
+      Assert(pU->coord().y() == pV->coord().y());
+      return 0;
+    }
+    const UInt_t xFrom = (UInt_t)((pU->coord().x() - _cir.xl()) / _scaleX);
+    const UInt_t xTo   = (UInt_t)((pV->coord().x() - _cir.xl()) / _scaleX);
+    const UInt_t yFrom = (UInt_t)((pU->coord().y() - _cir.yl()) / _scaleY);
+    const UInt_t yTo   = (UInt_t)((pV->coord().y() - _cir.yl()) / _scaleY);
+    const UInt_t xLo = std::min(xFrom, xTo), yLo = std::min(yFrom, yTo);
+    const UInt_t xHi = std::max(xFrom, xTo), yHi = std::max(yFrom, yTo);
+    for (UInt_t xId = xLo; xId <= xHi and xId < 64; ++xId) {
+      for (UInt_t yId = yLo; yId <= yHi and yId < 64; ++yId) {
+        ++count;
+        cost += _cir.routeGuide().cost(_netIdx, xId, yId);
+      }
+    }
+    if (count == 0)
+      return 0;
+    return cost / count;
+  }
+
+ private:
+  const CirDB&  _cir;
+  const UInt_t  _netIdx;
+  const Float_t _scaleX;
+  const Float_t _scaleY;
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _DR_GRID_ASTAR_COST_HPP_
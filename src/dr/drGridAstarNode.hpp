@@ -10,6 +10,7 @@
 #define _DR_GRID_ASTAR_NODE_HPP_
 
 #include "src/geo/point3d.hpp"
+#include "src/geo/box.hpp"
 
 PROJECT_NAMESPACE_START
 
@@ -25,6 +26,7 @@ class DrGridAstarNode {
     : _coord(co),
       _costG(g),
       _costF(f),
+      _costH(MAX_INT),
       _bendCnt(b),
       _bExplored(e),
       _pParent(p),
@@ -38,12 +40,17 @@ class DrGridAstarNode {
   const Point3d<Int_t>&               coord()       const { return _coord; }
   Int_t                               costG()       const { return _costG; }
   Int_t                               costF()       const { return _costF; }
+  Int_t                               costH()       const { return _costH; }
   Int_t                               bendCnt()     const { return _bendCnt; }
   bool                                bExplored()   const { return _bExplored; }
   DrGridAstarNode*                    pParent()     const { return _pParent; }
   Int_t                               dist2Tar()    const { return _dist2Tar; }
-  Vector_t<DrGridAstarNode*>&         vpNeighbors()       { return _vpNeighbors; }
-  const Vector_t<DrGridAstarNode*>&   vpNeighbors() const { return _vpNeighbors; }
+  UInt_t                              generation()  const { return _generation; }
+  Int_t                               heapIdx()     const { return _heapIdx; }
+  Int_t                               runArea()     const { return _runArea; }
+  bool                                bRunFromVia() const { return _bRunFromVia; }
+  // priority in the open list: costF first, then bendCnt
+  std::int64_t                        heapKey()     const { return (std::int64_t)_costF * ((std::int64_t)1 << 32) + _bendCnt; }
 
   /////////////////////////////////////////
   //    Setters                          //
@@ -51,55 +58,143 @@ class DrGridAstarNode {
   void setCoord(const Point3d<Int_t>& co) { _coord = co; }
   void setCostG(const Int_t c) { _costG = c; }
   void setCostF(const Int_t c) { _costF = c; }
+  void setCostH(const Int_t c) { _costH = c; }
   void setBendCnt(const Int_t c) { _bendCnt = c; }
   void setExplored(const bool b) { _bExplored = b; }
   void setParent(DrGridAstarNode* p) { _pParent = p; }
   void setDist2Tar(const Int_t d) { _dist2Tar = d; }
-  void addNeighbor(DrGridAstarNode* n) { _vpNeighbors.emplace_back(n); }
-  void setNeighbors(const Vector_t<DrGridAstarNode*>& v) { _vpNeighbors = v; }
+  void setGeneration(const UInt_t g) { _generation = g; }
+  void setHeapIdx(const Int_t i) { _heapIdx = i; }
+  void setRun(const Int_t a, const bool b) { _runArea = a; _bRunFromVia = b; }
   void reset() {
     _costG = MAX_INT;
     _costF = MAX_INT;
+    _costH = MAX_INT;
     _bendCnt = MAX_INT;
     _bExplored = false;
     _pParent = nullptr;
     _dist2Tar = MAX_INT;
+    _heapIdx = -1;
+    _runArea = 0;
+    _bRunFromVia = false;
   }
 
  private:
   Point3d<Int_t>              _coord;
   Int_t                       _costG;
   Int_t                       _costF;
+  Int_t                       _costH; ///< memoized heuristic, MAX_INT if not computed yet
   Int_t                       _bendCnt;
   
   bool                        _bExplored;
   DrGridAstarNode*            _pParent;
   Int_t                       _dist2Tar;
-  Vector_t<DrGridAstarNode*>  _vpNeighbors;
+  UInt_t                      _generation = 0; ///< the search this node was last reset for
+  Int_t                       _heapIdx = -1;   ///< position in the open list, -1 if not in it
+  Int_t                       _runArea = 0;    ///< area of the same-layer wire ending here, 0 if the parent is not in this layer
+  bool                        _bRunFromVia = false; ///< the same-layer wire starts at a via
 };
 
-struct DrGridAstarNodeCmp {
-  bool operator () (const DrGridAstarNode& n1, const DrGridAstarNode& n2) {
-    if (n1.costF() != n2.costF())
-      return n1.costF() > n2.costF();
-    else if (n1.bendCnt() != n2.bendCnt())
-      return n1.bendCnt() > n2.bendCnt();
-    //else if (n1.costG() != n2.costG())
-      //return n1.costG() > n2.costG();
-    else
-      return false;
+/////////////////////////////////////////
+//    Node arena                       //
+/////////////////////////////////////////
+// Nodes live in fixed-size tiles indexed by (layer, grid x, grid y) over a
+// bounding box of the search. Tiles are allocated on first touch, so a node
+// lookup is index arithmetic and the address of a node never changes.
+// Resetting bumps a generation counter; a node with an older stamp is reset
+// when it is looked up again.
+class DrGridAstarNodeArena {
+ public:
+  DrGridAstarNodeArena()
+    : _numLayers(0), _step(1), _offsetX(0), _offsetY(0),
+      _loGridX(0), _loGridY(0), _numTilesX(0), _numTilesY(0), _generation(0) {}
+  ~DrGridAstarNodeArena() {}
+
+  // bound: every grid point the search may reach
+  void init(const Int_t numLayers, const Int_t step,
+            const Int_t offsetX, const Int_t offsetY, const Box<Int_t>& bound) {
+    _numLayers = numLayers;
+    _step = step;
+    _offsetX = offsetX;
+    _offsetY = offsetY;
+    _loGridX = floorGrid(bound.xl() - offsetX);
+    _loGridY = floorGrid(bound.yl() - offsetY);
+    const Int_t numGridsX = floorGrid(bound.xh() - offsetX) - _loGridX + 1;
+    const Int_t numGridsY = floorGrid(bound.yh() - offsetY) - _loGridY + 1;
+    _numTilesX = (numGridsX + TileSize - 1) / TileSize;
+    _numTilesY = (numGridsY + TileSize - 1) / TileSize;
+    _vvTiles.clear();
+    _vvTiles.resize(_numLayers * _numTilesX * _numTilesY);
+    _vTileIndices.clear();
+    _generation = 0;
   }
-  bool operator () (const DrGridAstarNode* pN1, const DrGridAstarNode* pN2) {
-    if (pN1->costF() != pN2->costF())
-      return pN1->costF() > pN2->costF();
-    else if (pN1->bendCnt() != pN2->bendCnt())
-      return pN1->bendCnt() > pN2->bendCnt();
-    //else if (pN1->costG() != pN2->costG())
-      //return pN1->costG() > pN2->costG();
-    else
-      return false;
+
+  DrGridAstarNode* node(const Point3d<Int_t>& p) {
+    assert((p.x() - _offsetX) % _step == 0 and (p.y() - _offsetY) % _step == 0);
+    const Int_t gx = floorGrid(p.x() - _offsetX) - _loGridX;
+    const Int_t gy = floorGrid(p.y() - _offsetY) - _loGridY;
+    assert(p.z() >= 0 and p.z() < _numLayers);
+    assert(gx >= 0 and gx < _numTilesX * TileSize);
+    assert(gy >= 0 and gy < _numTilesY * TileSize);
+    const Int_t tileIdx = (p.z() * _numTilesY + gy / TileSize) * _numTilesX + gx / TileSize;
+    Vector_t<DrGridAstarNode>& vTile = _vvTiles[tileIdx];
+    if (vTile.empty()) {
+      allocTile(tileIdx, p.z(), gx / TileSize, gy / TileSize);
+    }
+    DrGridAstarNode* pNode = &vTile[(gy % TileSize) * TileSize + gx % TileSize];
+    if (pNode->generation() != _generation) {
+      pNode->reset();
+      pNode->setGeneration(_generation);
+    }
+    return pNode;
+  }
+
+  void resetAllNodes() {
+    if (++_generation == 0) {
+      // stamps wrapped around, clear them for real
+      for (const Int_t tileIdx : _vTileIndices) {
+        for (DrGridAstarNode& n : _vvTiles[tileIdx]) {
+          n.reset();
+          n.setGeneration(0);
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr Int_t TileSize = 16;
+
+  Int_t _numLayers;
+  Int_t _step;
+  Int_t _offsetX;
+  Int_t _offsetY;
+  Int_t _loGridX;
+  Int_t _loGridY;
+  Int_t _numTilesX;
+  Int_t _numTilesY;
+  UInt_t _generation;
+  Vector_t<Vector_t<DrGridAstarNode>> _vvTiles;       // empty until first touched
+  Vector_t<Int_t>                     _vTileIndices;  // allocated tiles
+
+  Int_t floorGrid(const Int_t d) const {
+    return d >= 0 ? d / _step : -((-d + _step - 1) / _step);
+  }
+
+  void allocTile(const Int_t tileIdx, const Int_t z, const Int_t tx, const Int_t ty) {
+    Vector_t<DrGridAstarNode>& vTile = _vvTiles[tileIdx];
+    vTile.resize(TileSize * TileSize);
+    for (Int_t j = 0; j < TileSize; ++j) {
+      for (Int_t i = 0; i < TileSize; ++i) {
+        const Int_t x = (_loGridX + tx * TileSize + i) * _step + _offsetX;
+        const Int_t y = (_loGridY + ty * TileSize + j) * _step + _offsetY;
+        vTile[j * TileSize + i].setCoord(Point3d<Int_t>(x, y, z));
+        vTile[j * TileSize + i].setGeneration(_generation);
+      }
+    }
+    _vTileIndices.emplace_back(tileIdx);
   }
 };
+
 PROJECT_NAMESPACE_END
 
 #endif /// _DR_GRID_ASTAR_NODE_HPP_
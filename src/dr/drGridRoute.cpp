@@ -12,12 +12,24 @@
 
 
 // performance-driven routing
-#include "paDrGridAstar.hpp"
-#include "gnDrGridAstar.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <tuple>
 
 PROJECT_NAMESPACE_START
 
 bool DrGridRoute::solve() {
+  buildViaCatalog();
+  if (_numTrials > 1) {
+    return solveTrials();
+  }
+  return solveOnce();
+}
+
+bool DrGridRoute::solveOnce() {
   bool bSuccess = true;
   
   // initialize net routing priority queue
@@ -37,6 +49,83 @@ bool DrGridRoute::solve() {
   return bSuccess;
 }
 
+bool DrGridRoute::solveTrials() {
+  // each trial routes its own copy of the circuit with a different seed
+  Vector_t<std::unique_ptr<CirDB>> vpCirs;
+  for (Int_t t = 0; t < _numTrials; ++t) {
+    vpCirs.emplace_back(new CirDB(_cir));
+  }
+  const Int_t numTrialThreads = std::max(_numThreads / _numTrials, 1);
+  Vector_t<Byte_t> vbSuccess(_numTrials, false);
+  ctpl::thread_pool pool(std::min(_numTrials, _numThreads));
+  for (Int_t t = 0; t < _numTrials; ++t) {
+    pool.push([&, t] (int) {
+      CirDB& cir = *vpCirs[t];
+      DrcMgr drc(cir);
+      DrGridRoute kernel(cir, _drMgr, drc, numTrialThreads);
+      kernel.setSeed(_param.seed + t);
+      vbSuccess[t] = kernel.solveOnce();
+    });
+  }
+  pool.stop(true);
+
+  // pick the best trial, ties go to the smaller seed
+  Int_t bestIdx = 0;
+  Int_t bestUnrouted = MAX_INT, bestWireLength = MAX_INT, bestVias = MAX_INT;
+  for (Int_t t = 0; t < _numTrials; ++t) {
+    Int_t numUnrouted, wireLength, numVias;
+    evalTrial(*vpCirs[t], numUnrouted, wireLength, numVias);
+    fprintf(stderr, "DrGridRoute::%s Trial %d (seed %u) unrouted %d wirelength %d vias %d\n",
+            __func__, t, _param.seed + t, numUnrouted, wireLength, numVias);
+    if (std::tie(numUnrouted, wireLength, numVias) < std::tie(bestUnrouted, bestWireLength, bestVias)) {
+      bestIdx = t;
+      bestUnrouted = numUnrouted;
+      bestWireLength = wireLength;
+      bestVias = numVias;
+    }
+  }
+  fprintf(stderr, "DrGridRoute::%s Select trial %d\n", __func__, bestIdx);
+  _cir.copyRoutingState(*vpCirs[bestIdx]);
+  if (!vbSuccess[bestIdx]) {
+    checkFailed();
+  }
+  return vbSuccess[bestIdx];
+}
+
+void DrGridRoute::evalTrial(const CirDB& cir, Int_t& numUnrouted, Int_t& wireLength, Int_t& numVias) {
+  numUnrouted = 0;
+  wireLength = 0;
+  numVias = 0;
+  for (Int_t i = 0; i < (Int_t)cir.numNets(); ++i) {
+    const Net& net = cir.net(i);
+    if (!net.bRouted()) {
+      ++numUnrouted;
+      continue;
+    }
+    for (const auto& pair : net.vRoutePaths()) {
+      const auto& u = pair.first;
+      const auto& v = pair.second;
+      if (u.z() != v.z())
+        ++numVias;
+      else
+        wireLength += std::abs(u.x() - v.x()) + std::abs(u.y() - v.y());
+    }
+  }
+}
+
+// fitted vias are only needed for the cut arrays the searches place
+void DrGridRoute::buildViaCatalog() {
+  Vector_t<Pair_t<UInt_t, UInt_t>> vNumCuts;
+  for (Int_t i = 0; i < (Int_t)_cir.numNets(); ++i) {
+    Int_t numCutsRow, numCutsCol;
+    PADrGridAstar::numCuts(_cir.net(i), numCutsRow, numCutsCol);
+    vNumCuts.emplace_back(numCutsRow, numCutsCol);
+  }
+  std::sort(vNumCuts.begin(), vNumCuts.end());
+  vNumCuts.erase(std::unique(vNumCuts.begin(), vNumCuts.end()), vNumCuts.end());
+  _cir.buildViaCatalog(vNumCuts);
+}
+
 void DrGridRoute::checkFailed() {
   fprintf(stderr, "!!!!!!!!!!!!!!!!! DR Failed !!!!!!!!!!!!!!!!\n");
   fprintf(stderr, "Unrouted Nets:");
@@ -60,9 +149,7 @@ bool DrGridRoute::solveDR(auto& pq, const bool bPower) {
   // second try
   fprintf(stderr, "DrGridRoute::%s Second Stage\n", __func__);
   // reset history map
-  for (auto& historyMap : _vSpatialHistoryMaps) {
-    historyMap.clear();
-  }
+  _historyGrid.clear();
   // reset net fail cnt
   for (Int_t i = 0; i < (Int_t)_cir.numNets(); ++i) {
     Net& net = _cir.net(i);
@@ -83,16 +170,19 @@ bool DrGridRoute::runNRR(auto& pq, const bool bPower, const Int_t maxIteration)
       std::cout << " " << pNet->name();
     }
     std::cout << std::endl;
+    Vector_t<Net*> vpNets;
     while (!pq.empty()) {
-      Net* pNet = pq.top();
+      vpNets.emplace_back(pq.top());
       pq.pop();
-
-      // start Astar routing (Hard DRC)
-      bool bSuccess = routeSingleNet(*pNet, true);
-      if (!bSuccess) {
-        bSuccess = routeSingleNet(*pNet, false);
-      }
-      assert(bSuccess);
+    }
+    if (_numThreads > 1 and _param.bOptimistic) {
+      routeNetsOptimistic(vpNets);
+    }
+    else if (_numThreads > 1) {
+      routeNetsParallel(vpNets);
+    }
+    else {
+      routeNetsSerial(vpNets);
     }
     // check DRC violations
     bool bFinish = checkDRC(bPower);
@@ -106,6 +196,229 @@ bool DrGridRoute::runNRR(auto& pq, const bool bPower, const Int_t maxIteration)
   return false;
 }
 
+void DrGridRoute::routeNetsSerial(const Vector_t<Net*>& vpNets) {
+  const Box<Int_t> dieBox(_cir.xl(), _cir.yl(), _cir.xh(), _cir.yh());
+  for (Net* pNet : vpNets) {
+    bool bSuccess = routeNet(*pNet, dieBox);
+    assert(bSuccess);
+  }
+}
+
+void DrGridRoute::routeNetsParallel(const Vector_t<Net*>& vpNets) {
+  Vector_t<Box<Int_t>> vWindows;
+  Vector_t<Vector_t<Net*>> vvRegionNets;
+  Vector_t<Net*> vpBoundaryNets;
+  partitionNets(vpNets, vWindows, vvRegionNets, vpBoundaryNets);
+
+  // boundary-crossing nets first, one by one over the whole die
+  routeNetsSerial(vpBoundaryNets);
+
+  // region windows are 2 * halo apart, so the concurrent searches never
+  // see each other's shapes and the result only depends on the partition
+  Vector_t<Vector_t<Net*>> vvFailedNets(vvRegionNets.size());
+  {
+    ctpl::thread_pool pool(_numThreads);
+    Vector_t<std::future<void>> vFutures;
+    for (Int_t i = 0; i < (Int_t)vvRegionNets.size(); ++i) {
+      if (vvRegionNets[i].empty())
+        continue;
+      vFutures.emplace_back(pool.push([this, i, &vWindows, &vvRegionNets, &vvFailedNets] (int) {
+        for (Net* pNet : vvRegionNets[i]) {
+          if (!routeNet(*pNet, vWindows[i])) {
+            vvFailedNets[i].emplace_back(pNet);
+          }
+        }
+      }));
+    }
+    for (auto& f : vFutures) {
+      f.get();
+    }
+  }
+
+  // nets that cannot be routed inside their windows are retried without the window
+  for (const auto& vpFailedNets : vvFailedNets) {
+    routeNetsSerial(vpFailedNets);
+  }
+}
+
+void DrGridRoute::routeNetsOptimistic(const Vector_t<Net*>& vpNets) {
+  // symmetric routing also writes the mirrored side, keep these nets serial
+  Vector_t<Net*> vpSymNets;
+  Vector_t<Int_t> vReadyIndices;
+  for (Int_t i = 0; i < (Int_t)vpNets.size(); ++i) {
+    if (vpNets[i]->hasSymNet() or vpNets[i]->bSelfSym())
+      vpSymNets.emplace_back(vpNets[i]);
+    else
+      vReadyIndices.emplace_back(i);
+  }
+  routeNetsSerial(vpSymNets);
+
+  // ready queue of (net index in vpNets, number of commit conflicts)
+  std::deque<Pair_t<Int_t, Int_t>> qReady;
+  for (const Int_t i : vReadyIndices) {
+    qReady.emplace_back(i, 0);
+  }
+  std::mutex queueMutex;
+  std::condition_variable queueCv;
+  Int_t numBusy = 0;
+  // every commit bumps the epoch; a search that saw no commit needs no validation
+  std::mutex commitMutex;
+  Int_t commitEpoch = 0;
+  Int_t numConflicts = 0;
+  Vector_t<Byte_t> vbFailed(vpNets.size(), false);
+
+  // route one routable of a net per task, so a net is never searched twice at the same time
+  auto routeTask = [&] (const Int_t netIdx, Int_t& conflictCnt) -> bool {
+    Net& net = *vpNets[netIdx];
+    Int_t roIdx = 0;
+    while (roIdx < net.numRoutables() and net.routable(roIdx).bRouted()) {
+      ++roIdx;
+    }
+    if (roIdx == net.numRoutables())
+      return false;
+    // the search reads the routed wires of exactly the commits before snapshotEpoch
+    Int_t snapshotEpoch;
+    RoutedWireStore::SnapshotPtr pRoutedWires;
+    {
+      std::lock_guard<std::mutex> lock(commitMutex);
+      snapshotEpoch = commitEpoch;
+      pRoutedWires = _cir.routedWireSnapshot();
+    }
+    PADrGridAstar kernel(_cir, net, net.routable(roIdx), this->_drc, *this, false, false, true);
+    kernel.setDeferCommit(true);
+    kernel.setRoutedWireSnapshot(pRoutedWires);
+    if (!kernel.run()) {
+      vbFailed[netIdx] = true;
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(commitMutex);
+    bool bValid = (snapshotEpoch == commitEpoch);
+    if (!bValid) {
+      bValid = true;
+      for (const auto& vWires : kernel.vvRoutedWires()) {
+        bValid &= checkWiresDRC(net.idx(), vWires);
+      }
+    }
+    if (!bValid) {
+      ++numConflicts;
+      if (++conflictCnt > _param.maxCommitConflicts) {
+        vbFailed[netIdx] = true;
+        return false;
+      }
+      return true;
+    }
+    kernel.commit();
+    _cir.publishRoutedWires();
+    ++commitEpoch;
+    return !net.bRouted();
+  };
+
+  // searches read the routed wires of the nets committed so far
+  _cir.publishRoutedWires();
+  {
+    ctpl::thread_pool pool(_numThreads);
+    Vector_t<std::future<void>> vFutures;
+    for (Int_t t = 0; t < _numThreads; ++t) {
+      vFutures.emplace_back(pool.push([&] (int) {
+        while (true) {
+          Pair_t<Int_t, Int_t> task;
+          {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCv.wait(lock, [&] { return !qReady.empty() or numBusy == 0; });
+            if (qReady.empty())
+              return;
+            task = qReady.front();
+            qReady.pop_front();
+            ++numBusy;
+          }
+          const bool bRequeue = routeTask(task.first, task.second);
+          {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (bRequeue)
+              qReady.emplace_back(task);
+            --numBusy;
+          }
+          queueCv.notify_all();
+        }
+      }));
+    }
+    for (auto& f : vFutures) {
+      f.get();
+    }
+  }
+  fprintf(stderr, "DrGridRoute::%s %d commits, %d conflicts\n", __func__, commitEpoch, numConflicts);
+
+  // failed or repeatedly conflicting nets are rerouted one by one
+  Vector_t<Net*> vpFailedNets;
+  for (Int_t i = 0; i < (Int_t)vpNets.size(); ++i) {
+    if (vbFailed[i])
+      vpFailedNets.emplace_back(vpNets[i]);
+  }
+  routeNetsSerial(vpFailedNets);
+}
+
+void DrGridRoute::partitionNets(const Vector_t<Net*>& vpNets,
+                                Vector_t<Box<Int_t>>& vWindows,
+                                Vector_t<Vector_t<Net*>>& vvRegionNets,
+                                Vector_t<Net*>& vpBoundaryNets) {
+  // region grid depends only on the thread count
+  const Int_t numRegions = _numThreads * _param.numRegionsPerThread;
+  const Int_t numRegionsX = std::ceil(std::sqrt(numRegions));
+  const Int_t numRegionsY = (numRegions + numRegionsX - 1) / numRegionsX;
+  const Int_t cellWidth = (_cir.xh() - _cir.xl() + numRegionsX - 1) / numRegionsX;
+  const Int_t cellHeight = (_cir.yh() - _cir.yl() + numRegionsY - 1) / numRegionsY;
+  const Int_t halo = _param.regionHalo * _cir.gridStep();
+
+  vWindows.clear();
+  vvRegionNets.clear();
+  vpBoundaryNets.clear();
+  vWindows.reserve(numRegionsX * numRegionsY);
+  for (Int_t j = 0; j < numRegionsY; ++j) {
+    for (Int_t i = 0; i < numRegionsX; ++i) {
+      vWindows.emplace_back(_cir.xl() + i * cellWidth + halo,
+                            _cir.yl() + j * cellHeight + halo,
+                            _cir.xl() + (i + 1) * cellWidth - halo,
+                            _cir.yl() + (j + 1) * cellHeight - halo);
+    }
+  }
+  vvRegionNets.resize(vWindows.size());
+
+  for (Net* pNet : vpNets) {
+    // symmetric routing also writes the mirrored side, keep these nets serial
+    if (pNet->hasSymNet() or pNet->bSelfSym()) {
+      vpBoundaryNets.emplace_back(pNet);
+      continue;
+    }
+    const Box<Int_t> bbox = pNet->bbox();
+    const Int_t i = std::min(std::max((bbox.centerX() - _cir.xl()) / std::max(cellWidth, 1), 0), numRegionsX - 1);
+    const Int_t j = std::min(std::max((bbox.centerY() - _cir.yl()) / std::max(cellHeight, 1), 0), numRegionsY - 1);
+    const Int_t regionIdx = j * numRegionsX + i;
+    const Box<Int_t>& window = vWindows[regionIdx];
+    if (window.xl() < window.xh() and window.yl() < window.yh()
+        and Box<Int_t>::bCover(window, bbox)) {
+      vvRegionNets[regionIdx].emplace_back(pNet);
+    }
+    else {
+      vpBoundaryNets.emplace_back(pNet);
+    }
+  }
+  fprintf(stderr, "DrGridRoute::%s %d regions, %d boundary nets\n", __func__,
+          (Int_t)vWindows.size(), (Int_t)vpBoundaryNets.size());
+}
+
+bool DrGridRoute::routeNet(Net& net, const Box<Int_t>& window) {
+  if (_numThreads > 1 and _param.bPortfolio
+      and !net.hasSymNet() and !net.bSelfSym()) {
+    return routeSingleNetPortfolio(net, window);
+  }
+  // start Astar routing (Hard DRC)
+  bool bSuccess = routeSingleNet(net, true, window);
+  if (!bSuccess) {
+    bSuccess = routeSingleNet(net, false, window);
+  }
+  return bSuccess;
+}
+
 void DrGridRoute::addUnroutedNetsToPQ(auto& pq, const bool bPower) {
   for (Int_t i = 0; i < (Int_t)_cir.numNets(); ++i) {
     Net* pNet = &_cir.net(i);
@@ -137,7 +450,7 @@ void DrGridRoute::checkSymSelfSym(const Net& net, const Routable& ro, bool& bSym
   }
 }
 
-bool DrGridRoute::routeSingleNet(Net& net, const bool bStrictDRC) {
+bool DrGridRoute::routeSingleNet(Net& net, const bool bStrictDRC, const Box<Int_t>& window) {
   
   if (net.hasSymNet()) {
     assert(!net.bPower());
@@ -166,6 +479,7 @@ bool DrGridRoute::routeSingleNet(Net& net, const bool bStrictDRC) {
 
     // DrGridAstar kernel(_cir, net, ro, this->_drc, *this, bSym, bSelfSym, bStrictDRC);
     PADrGridAstar kernel(_cir, net, ro, this->_drc, *this, bSym, bSelfSym, bStrictDRC);
+    kernel.setWindow(window);
     // gnDrGridAstar kernel(_cir, net, ro, this->_drc, *this, bSym, bSelfSym, bStrictDRC);
     if (!kernel.run())
       return false;
@@ -173,24 +487,132 @@ bool DrGridRoute::routeSingleNet(Net& net, const bool bStrictDRC) {
   return true;
 }
 
+bool DrGridRoute::routeSingleNetPortfolio(Net& net, const Box<Int_t>& window) {
+  for (Int_t i = 0; i < net.numRoutables(); ++i) {
+    auto& ro = net.routable(i);
+    if (ro.bRouted())
+      continue;
+    // the strict and relaxed searches run on private state,
+    // the strict result is kept unless the relaxed one is clean before it
+    PADrGridAstar strictKernel(_cir, net, ro, this->_drc, *this, false, false, true);
+    PADrGridAstar relaxedKernel(_cir, net, ro, this->_drc, *this, false, false, false);
+    strictKernel.setWindow(window);
+    relaxedKernel.setWindow(window);
+    strictKernel.setDeferCommit(true);
+    relaxedKernel.setDeferCommit(true);
+    std::atomic<bool> bCancelStrict(false);
+    std::atomic<bool> bCancelRelaxed(false);
+    strictKernel.setCancelFlag(&bCancelStrict);
+    relaxedKernel.setCancelFlag(&bCancelRelaxed);
+
+    bool bStrictSuccess = false;
+    bool bRelaxedSuccess = false;
+    if (acquirePortfolioThread()) {
+      // a clean relaxed result is as legal as the strict one, stop waiting for it
+      auto relaxedFuture = _pPortfolioPool->push([&] (int) {
+        bRelaxedSuccess = relaxedKernel.run();
+        if (bRelaxedSuccess) {
+          bool bClean = true;
+          for (const auto& vWires : relaxedKernel.vvRoutedWires()) {
+            bClean = bClean and checkWiresDRC(net.idx(), vWires);
+          }
+          if (bClean) {
+            bCancelStrict = true;
+          }
+        }
+      });
+      bStrictSuccess = strictKernel.run();
+      if (bStrictSuccess) {
+        bCancelRelaxed = true;
+      }
+      relaxedFuture.get();
+      ++_numIdlePortfolioThreads;
+    }
+    else {
+      // no idle core, same order as the sequential flow
+      bStrictSuccess = strictKernel.run();
+      if (!bStrictSuccess) {
+        bRelaxedSuccess = relaxedKernel.run();
+      }
+    }
+
+    if (bStrictSuccess) {
+      strictKernel.commit();
+    }
+    else if (bRelaxedSuccess) {
+      relaxedKernel.commit();
+    }
+    else {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DrGridRoute::initPortfolioPool() {
+  // the relaxed searches only get the cores the routing threads leave idle,
+  // so the machine is never oversubscribed
+  const Int_t numHelpers = _param.numPortfolioThreads > 0 ?
+                           _param.numPortfolioThreads :
+                           (Int_t)std::thread::hardware_concurrency() - _numThreads;
+  if (numHelpers > 0) {
+    _pPortfolioPool.reset(new ctpl::thread_pool(numHelpers));
+    _numIdlePortfolioThreads = numHelpers;
+  }
+}
+
+// take an idle portfolio thread if there is one, give it back with ++_numIdlePortfolioThreads
+bool DrGridRoute::acquirePortfolioThread() {
+  Int_t numIdle = _numIdlePortfolioThreads.load();
+  while (numIdle > 0) {
+    if (_numIdlePortfolioThreads.compare_exchange_weak(numIdle, numIdle - 1))
+      return true;
+  }
+  return false;
+}
+
 bool DrGridRoute::checkDRC(const bool bPower) {
-  // randomize the checking sequence
-  Vector_t<Int_t> vIndices;
-  for (Int_t i = 0; i < (Int_t)_cir.numNets(); ++i) {
-    vIndices.emplace_back(i);
+  const Int_t numNets = _cir.numNets();
+
+  // read-only check of all nets
+  Vector_t<Byte_t> vbViolate(numNets, false);
+  auto checkNets = [&] (const Int_t begin, const Int_t end) {
+    for (Int_t i = begin; i < end; ++i) {
+      vbViolate[i] = !checkSingleNetDRC(_cir.net(i));
+    }
+  };
+  if (_numThreads > 1) {
+    ctpl::thread_pool pool(_numThreads);
+    Vector_t<std::future<void>> vFutures;
+    const Int_t chunkSize = std::max(numNets / (_numThreads * 8), 1);
+    for (Int_t begin = 0; begin < numNets; begin += chunkSize) {
+      const Int_t end = std::min(begin + chunkSize, numNets);
+      vFutures.emplace_back(pool.push([&checkNets, begin, end] (int) { checkNets(begin, end); }));
+    }
+    for (auto& f : vFutures) {
+      f.get();
+    }
+  }
+  else {
+    checkNets(0, numNets);
   }
-  std::random_shuffle(vIndices.begin(), vIndices.end());
+
+  // randomize the ripup sequence
+  Vector_t<Int_t> vIndices(numNets);
+  std::iota(vIndices.begin(), vIndices.end(), 0);
+  std::shuffle(vIndices.begin(), vIndices.end(), _rng);
   bool bValid = true;
   for (auto i : vIndices) {
     Net& net = _cir.net(i);
+    if (!vbViolate[i] or net.bPower() != bPower)
+      continue;
+    // the nets ripped up before may have resolved the violations
     if (!checkSingleNetDRC(net)) {
-      if (net.bPower() == bPower) {
-        ripupSingleNet(net);
-        //for (Int_t j = 0; j < (Int_t)_cir.numNets(); ++j) {
-          //ripupSingleNet(_cir.net(j));
-        //}
-        bValid = false;
-      }
+      ripupSingleNet(net);
+      //for (Int_t j = 0; j < (Int_t)_cir.numNets(); ++j) {
+        //ripupSingleNet(_cir.net(j));
+      //}
+      bValid = false;
     }
   }
   return bValid;
@@ -201,19 +623,23 @@ bool DrGridRoute::checkSingleNetDRC(const Net& net) {
   if (!_drc.checkSameNetRoutingLayerSpacing(net.idx()))
     return false;
   // check other nets
-  for (const auto& pair : net.vWires()) {
+  return checkWiresDRC(net.idx(), net.vWires());
+}
+
+bool DrGridRoute::checkWiresDRC(const UInt_t netIdx, const Vector_t<Pair_t<Box<Int_t>, Int_t>>& vWires) {
+  for (const auto& pair : vWires) {
     const auto& wire = pair.first;
     const Int_t layerIdx = pair.second;
     if (_cir.lef().bRoutingLayer(layerIdx)) {
       const Int_t prl = std::max(wire.width(), wire.height());
-      if (!_drc.checkWireRoutingLayerSpacing(net.idx(), layerIdx, wire, prl))
+      if (!_drc.checkWireRoutingLayerSpacing(netIdx, layerIdx, wire, prl))
         return false;
-      if (!_drc.checkWireEolSpacing(net.idx(), layerIdx, wire))
+      if (!_drc.checkWireEolSpacing(netIdx, layerIdx, wire))
         return false;
     }
     else {
       assert(_cir.lef().bCutLayer(layerIdx));
-      if (!_drc.checkWireCutLayerSpacing(net.idx(), layerIdx, wire))
+      if (!_drc.checkWireCutLayerSpacing(netIdx, layerIdx, wire))
         return false;
     }
   }
@@ -221,6 +647,12 @@ bool DrGridRoute::checkSingleNetDRC(const Net& net) {
 }
 
 void DrGridRoute::ripupSingleNet(Net& net) {
+  // paths that violate with each other cannot be reused one by one
+  if (_drc.checkSameNetRoutingLayerSpacing(net.idx()))
+    _vvNetPathCache[net.idx()].swap(_vvNetRoutedPaths[net.idx()]);
+  else
+    _vvNetPathCache[net.idx()].clear();
+  _vvNetRoutedPaths[net.idx()].clear();
   for (const auto& pair : net.vWires()) {
     const auto& wire = pair.first;
     const Int_t layerIdx = pair.second;
@@ -233,6 +665,11 @@ void DrGridRoute::ripupSingleNet(Net& net) {
   // check sym net
   if (net.hasSymNet()) {
     Net& symNet = _cir.net(net.symNetIdx());
+    if (_drc.checkSameNetRoutingLayerSpacing(symNet.idx()))
+      _vvNetPathCache[symNet.idx()].swap(_vvNetRoutedPaths[symNet.idx()]);
+    else
+      _vvNetPathCache[symNet.idx()].clear();
+    _vvNetRoutedPaths[symNet.idx()].clear();
     for (const auto& pair : symNet.vWires()) {
       const auto& wire = pair.first;
       const Int_t layerIdx = pair.second;
@@ -247,7 +684,7 @@ void DrGridRoute::ripupSingleNet(Net& net) {
 
 
 void DrGridRoute::addWireHistoryCost(const Int_t cost, const Int_t layerIdx, const Box<Int_t>& wire) {
-  _vSpatialHistoryMaps[layerIdx].insert(wire, cost);
+  _historyGrid.add(layerIdx, wire, cost);
 }
 
 void DrGridRoute::addViaHistoryCost(const Int_t cost, const Int_t x, const Int_t y, const LefVia& via) {
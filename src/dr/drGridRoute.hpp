@@ -10,32 +10,65 @@
 #define _DR_GRID_ROUTE_HPP_
 
 #include "drMgr.hpp"
+#include "drHistoryGrid.hpp"
 #include "src/geo/spatial.hpp"
 #include "src/ds/pqueue.hpp"
+#include "include/ctpl.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
 
 PROJECT_NAMESPACE_START
 
 class DrGridRoute {
-  friend class DrGridAstar;
-  friend class PADrGridAstar;
-  friend class gnDrGridAstar;
+  template <typename CostPolicy> friend class DrGridAstarKernel;
 
  public:
-  DrGridRoute(CirDB& c, DrMgr& dr, DrcMgr& drc)
-    : _cir(c), _drMgr(dr), _drc(drc),
-      _vSpatialHistoryMaps(c.lef().numLayers()) {}
+  DrGridRoute(CirDB& c, DrMgr& dr, DrcMgr& drc, const Int_t numThreads = 1, const Int_t numTrials = 1)
+    : _cir(c), _drMgr(dr), _drc(drc), _numThreads(numThreads), _numTrials(numTrials) {
+    _rng.seed(_param.seed);
+    _param.bOptimistic = dr.bOptimistic();
+    _param.bPortfolio = dr.bPortfolio();
+    _param.numPortfolioThreads = dr.numPortfolioThreads();
+    _param.bBoxHeuristic = dr.bBoxHeuristic();
+    _param.bBidirectional = dr.bBidirectional();
+    // searches may step one grid outside the die
+    Box<Int_t> bound(c.xl(), c.yl(), c.xh(), c.yh());
+    bound.expand(c.gridStep());
+    // searches only stand on routing layers, the history of cut layers is never read
+    Vector_t<Byte_t> vbHistoryLayers(c.lef().numLayers(), false);
+    for (UInt_t i = 0; i < c.lef().numLayers(); ++i) {
+      vbHistoryLayers[i] = c.lef().bRoutingLayer(i);
+    }
+    _historyGrid.init(vbHistoryLayers, c.gridStep(), c.gridOffsetX(), c.gridOffsetY(), bound);
+    _vvNetRoutedPaths.resize(c.numNets());
+    _vvNetPathCache.resize(c.numNets());
+    if (_numThreads > 1 and _param.bPortfolio) {
+      initPortfolioPool();
+    }
+  }
   ~DrGridRoute() {}
 
   bool solve();
   bool solveDR(auto& pq, const bool bPower);
   void checkFailed();
+  void setSeed(const UInt_t s) { _param.seed = s; _rng.seed(s); }
 
  private:
   CirDB&    _cir;
   DrMgr&    _drMgr;
   DrcMgr&   _drc;
+  const Int_t _numThreads;
+  const Int_t _numTrials;
   
-  Vector_t<SpatialMap<Int_t, Int_t>> _vSpatialHistoryMaps;
+  DrHistoryGrid                      _historyGrid; ///< safe to read and add from concurrent searches
+
+  std::mt19937 _rng; ///< drives the ripup order in checkDRC
+
+  std::unique_ptr<ctpl::thread_pool> _pPortfolioPool; ///< runs the relaxed searches of portfolio routing
+  std::atomic<Int_t>                 _numIdlePortfolioThreads{0};
 
   /////////////////////////////////////////
   //    Private structs                  //
@@ -103,26 +136,66 @@ class DrGridRoute {
     }
   };
 
+  // the path of one subnet and the shapes it generated
+  struct SubNetPath {
+    Vector_t<Pair_t<Point3d<Int_t>, Point3d<Int_t>>> vPath;
+    Vector_t<Pair_t<Box<Int_t>, Int_t>>              vWires;
+  };
+
   struct Param {
     Int_t maxSymTry = 5;
     Int_t maxSelfSymTry = 5;
     Int_t maxIteration = 15;
     Int_t maxIteration2 = 20;
+    UInt_t seed = 1234;
+    // parallel routing
+    bool  bPortfolio = false; // run strict and relaxed searches concurrently
+    Int_t numPortfolioThreads = 0; // threads of the relaxed searches, 0 for the cores the routing threads leave idle
+    Int_t numRegionsPerThread = 2;
+    Int_t regionHalo = 10; // grid steps kept free between a region window and its cell border
+    bool  bOptimistic = false; // route any ready net concurrently and validate at commit instead of partitioning
+    Int_t maxCommitConflicts = 3; // optimistic retries before a net falls back to serial routing
+    // path search
+    bool  bBoxHeuristic = false; // A* bound by the target bounding box instead of the nearest target point
+    bool  bBidirectional = false; // search each subnet from both of its components
   } _param;
+
+  // subnet paths of the current routing of each net, moved to the cache on ripup
+  // so that the next iteration only searches the subnets whose paths became invalid
+  Vector_t<Vector_t<SubNetPath>> _vvNetRoutedPaths;
+  Vector_t<Vector_t<SubNetPath>> _vvNetPathCache;
   
   /////////////////////////////////////////
   //    Private functions                //
   /////////////////////////////////////////
+  bool solveOnce();
+  bool solveTrials();
+  void evalTrial(const CirDB& cir, Int_t& numUnrouted, Int_t& wireLength, Int_t& numVias);
+  void buildViaCatalog();
+
   void addUnroutedNetsToPQ(auto& pq, const bool bPower);
 
   void checkSymSelfSym(const Net& net, const Routable& ro, bool& bSym, bool& bSelfSym);
 
   bool runNRR(auto& pq, const bool bPower, const Int_t maxIteration);
 
-  bool routeSingleNet(Net& net, const bool bStrictDRC);
+  void routeNetsSerial(const Vector_t<Net*>& vpNets);
+  void routeNetsParallel(const Vector_t<Net*>& vpNets);
+  void routeNetsOptimistic(const Vector_t<Net*>& vpNets);
+  void partitionNets(const Vector_t<Net*>& vpNets,
+                     Vector_t<Box<Int_t>>& vWindows,
+                     Vector_t<Vector_t<Net*>>& vvRegionNets,
+                     Vector_t<Net*>& vpBoundaryNets);
+  bool routeNet(Net& net, const Box<Int_t>& window);
+
+  bool routeSingleNet(Net& net, const bool bStrictDRC, const Box<Int_t>& window);
+  bool routeSingleNetPortfolio(Net& net, const Box<Int_t>& window);
+  void initPortfolioPool();
+  bool acquirePortfolioThread();
 
   bool checkDRC(const bool bPower);
   bool checkSingleNetDRC(const Net& net);
+  bool checkWiresDRC(const UInt_t netIdx, const Vector_t<Pair_t<Box<Int_t>, Int_t>>& vWires);
   
   void ripupSingleNet(Net& net);
   
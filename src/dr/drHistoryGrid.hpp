@@ -0,0 +1,128 @@
+/**
+ * @file   drHistoryGrid.hpp
+ * @brief  Detailed Routing - Dense history cost map on the routing grid
+ *
+ **/
+
+#ifndef _DR_HISTORY_GRID_HPP_
+#define _DR_HISTORY_GRID_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/box.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+PROJECT_NAMESPACE_START
+
+// The accumulated history cost of every grid point in each layer.
+// Adding a box adds its cost to all the grid points it covers; a point
+// lookup is index arithmetic. Points outside the bound are summed over the
+// boxes that stick out of it, which only happens around off-die access points.
+// Only the layers searches stand on (routing layers) get a grid; the others
+// ignore add() and cost nothing.
+// add() and cost() may run in different threads without outside locking:
+// a grid point is a relaxed atomic, so a lookup is still a plain load, and
+// a concurrent lookup may see a box half added. Only the boxes outside the
+// bound are behind a lock.
+class DrHistoryGrid {
+ public:
+  DrHistoryGrid()
+    : _step(1), _offsetX(0), _offsetY(0),
+      _loGridX(0), _loGridY(0), _numGridsX(0), _numGridsY(0) {}
+  ~DrHistoryGrid() {}
+
+  // vbLayers[i]: layer i gets a grid
+  void init(const Vector_t<Byte_t>& vbLayers, const Int_t step,
+            const Int_t offsetX, const Int_t offsetY, const Box<Int_t>& bound) {
+    _step = step;
+    _offsetX = offsetX;
+    _offsetY = offsetY;
+    _loGridX = floorGrid(bound.xl() - offsetX);
+    _loGridY = floorGrid(bound.yl() - offsetY);
+    _numGridsX = floorGrid(bound.xh() - offsetX) - _loGridX + 1;
+    _numGridsY = floorGrid(bound.yh() - offsetY) - _loGridY + 1;
+    _vpCosts.clear();
+    for (const Byte_t b : vbLayers) {
+      _vpCosts.emplace_back(b ? new std::atomic<Int_t>[_numGridsX * _numGridsY]() : nullptr);
+    }
+    _vvOutBoxes.assign(vbLayers.size(), Vector_t<Pair_t<Box<Int_t>, Int_t>>());
+  }
+
+  // range update: add cost to every grid point inside box
+  void add(const Int_t layerIdx, const Box<Int_t>& box, const Int_t cost) {
+    if (!_vpCosts[layerIdx])
+      return;
+    const Int_t gxl = ceilGrid(box.xl() - _offsetX) - _loGridX;
+    const Int_t gyl = ceilGrid(box.yl() - _offsetY) - _loGridY;
+    const Int_t gxh = floorGrid(box.xh() - _offsetX) - _loGridX;
+    const Int_t gyh = floorGrid(box.yh() - _offsetY) - _loGridY;
+    if (gxl < 0 or gyl < 0 or gxh >= _numGridsX or gyh >= _numGridsY) {
+      std::unique_lock<std::shared_timed_mutex> lock(_outBoxMutex);
+      _vvOutBoxes[layerIdx].emplace_back(box, cost);
+    }
+    std::atomic<Int_t>* pCosts = _vpCosts[layerIdx].get();
+    for (Int_t gy = std::max(gyl, 0); gy <= std::min(gyh, _numGridsY - 1); ++gy) {
+      std::atomic<Int_t>* pRow = &pCosts[gy * _numGridsX];
+      for (Int_t gx = std::max(gxl, 0); gx <= std::min(gxh, _numGridsX - 1); ++gx) {
+        pRow[gx].fetch_add(cost, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  Int_t cost(const Int_t layerIdx, const Int_t x, const Int_t y) const {
+    if (!_vpCosts[layerIdx])
+      return 0;
+    const Int_t gx = floorGrid(x - _offsetX) - _loGridX;
+    const Int_t gy = floorGrid(y - _offsetY) - _loGridY;
+    if (gx >= 0 and gy >= 0 and gx < _numGridsX and gy < _numGridsY) {
+      return _vpCosts[layerIdx][gy * _numGridsX + gx].load(std::memory_order_relaxed);
+    }
+    std::shared_lock<std::shared_timed_mutex> lock(_outBoxMutex);
+    Int_t sum = 0;
+    for (const Pair_t<Box<Int_t>, Int_t>& pair : _vvOutBoxes[layerIdx]) {
+      const Box<Int_t>& box = pair.first;
+      if (box.xl() <= x and x <= box.xh() and box.yl() <= y and y <= box.yh())
+        sum += pair.second;
+    }
+    return sum;
+  }
+
+  void clear() {
+    for (auto& pCosts : _vpCosts) {
+      if (!pCosts)
+        continue;
+      for (Int_t i = 0; i < _numGridsX * _numGridsY; ++i) {
+        pCosts[i].store(0, std::memory_order_relaxed);
+      }
+    }
+    for (auto& vOutBoxes : _vvOutBoxes) {
+      vOutBoxes.clear();
+    }
+  }
+
+ private:
+  Int_t _step;
+  Int_t _offsetX;
+  Int_t _offsetY;
+  Int_t _loGridX;
+  Int_t _loGridY;
+  Int_t _numGridsX;
+  Int_t _numGridsY;
+  Vector_t<std::unique_ptr<std::atomic<Int_t>[]>>  _vpCosts;     // [layer][gy * numGridsX + gx], null without grid
+  Vector_t<Vector_t<Pair_t<Box<Int_t>, Int_t>>>     _vvOutBoxes;  // boxes not inside the bound
+  mutable std::shared_timed_mutex                   _outBoxMutex; // guards _vvOutBoxes
+
+  Int_t floorGrid(const Int_t d) const {
+    return d >= 0 ? d / _step : -((-d + _step - 1) / _step);
+  }
+  Int_t ceilGrid(const Int_t d) const {
+    return -floorGrid(-d);
+  }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _DR_HISTORY_GRID_HPP_
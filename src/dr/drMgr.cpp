@@ -15,10 +15,10 @@
 
 PROJECT_NAMESPACE_START
 
-bool DrMgr::solve(const bool bGrid, const bool bUseSymFile) {
+bool DrMgr::solve(const bool bGrid, const bool bUseSymFile, const Int_t numThreads, const Int_t numTrials) {
   fprintf(stderr, "\nDrMgr::%s Start Detailed Routing\n", __func__);
   if (bGrid)
-    return runGridRoute(bUseSymFile);
+    return runGridRoute(bUseSymFile, numThreads, numTrials);
   else
     return runGridlessRoute();
 }
@@ -28,7 +28,7 @@ bool DrMgr::runGridlessRoute() {
   return kernel.solve();
 }
 
-bool DrMgr::runGridRoute(const bool bUseSymFile) {
+bool DrMgr::runGridRoute(const bool bUseSymFile, const Int_t numThreads, const Int_t numTrials) {
 
   DrSymmetry sym(_cir);
   sym.solve(bUseSymFile);
@@ -36,7 +36,7 @@ bool DrMgr::runGridRoute(const bool bUseSymFile) {
   DrRoutable ro(_cir);
   ro.constructRoutables();
 
-  DrGridRoute kernel(_cir, *this, _drcMgr);
+  DrGridRoute kernel(_cir, *this, _drcMgr, numThreads, numTrials);
   return kernel.solve();
 }
 
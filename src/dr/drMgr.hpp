@@ -18,16 +18,34 @@ PROJECT_NAMESPACE_START
 class DrMgr {
  public:
   DrMgr(CirDB& c, DrcMgr& d)
-    : _cir(c), _drcMgr(d) {}
+    : _cir(c), _drcMgr(d), _bOptimistic(false), _bPortfolio(false), _numPortfolioThreads(0),
+      _bBoxHeuristic(false), _bBidirectional(false) {}
   ~DrMgr() {}
 
-  bool solve(const bool bGrid = true, const bool bUseSymFile = false);
+  bool solve(const bool bGrid = true, const bool bUseSymFile = false, const Int_t numThreads = 1, const Int_t numTrials = 1);
   bool runGridlessRoute();
-  bool runGridRoute(const bool bUseSymFile);
+  bool runGridRoute(const bool bUseSymFile, const Int_t numThreads, const Int_t numTrials);
+
+  // grid routing modes, read by every DrGridRoute kernel
+  bool  bOptimistic()                          const { return _bOptimistic; }
+  bool  bPortfolio()                           const { return _bPortfolio; }
+  Int_t numPortfolioThreads()                  const { return _numPortfolioThreads; }
+  bool  bBoxHeuristic()                        const { return _bBoxHeuristic; }
+  bool  bBidirectional()                       const { return _bBidirectional; }
+  void  setOptimistic(const bool b)                  { _bOptimistic = b; }
+  void  setPortfolio(const bool b)                   { _bPortfolio = b; }
+  void  setNumPortfolioThreads(const Int_t n)        { _numPortfolioThreads = n; }
+  void  setBoxHeuristic(const bool b)                { _bBoxHeuristic = b; }
+  void  setBidirectional(const bool b)               { _bBidirectional = b; }
 
  private:
   CirDB&  _cir;
   DrcMgr& _drcMgr;
+  bool    _bOptimistic; ///< route nets concurrently and validate at commit, needs numThreads > 1
+  bool    _bPortfolio; ///< race a relaxed search against the strict one, needs numThreads > 1
+  Int_t   _numPortfolioThreads; ///< threads of the relaxed searches, 0 for the idle cores
+  bool    _bBoxHeuristic; ///< A* heuristic toward the target bounding box, cheaper but looser
+  bool    _bBidirectional; ///< A* searches each subnet from both ends
   /////////////////////////////////////////
   //    Private structs                  //
   /////////////////////////////////////////
@@ -19,43 +19,29 @@ PROJECT_NAMESPACE_START
 // short
 bool DrcMgr::checkWireRoutingLayerShort(const UInt_t netIdx, const UInt_t layerIdx, const Box<Int_t>& b) const {
   // check pin
-  Vector_t<UInt_t> vPinIndices;
-  _cir.querySpatialPin(layerIdx, b, vPinIndices);
-  for (const UInt_t pinIdx : vPinIndices) {
-    const Pin& pin = _cir.pin(pinIdx);
-    if (pin.netIdx() != netIdx)
-      return false;
-  }
+  if (_cir.existSpatialPin(layerIdx, b, [&] (const Box<Int_t>& box, const UInt_t pinIdx) {
+        return _cir.pin(pinIdx).netIdx() != netIdx;
+      }))
+    return false;
   // check other net's wires
-  Vector_t<UInt_t> vNetIndices;
-  Vector_t<Box<Int_t>> vBoxes;
-  _cir.querySpatialRoutedWire(layerIdx, b, vNetIndices, vBoxes);
-  for (const UInt_t idx : vNetIndices) {
-    if (idx != netIdx)
-      return false;
-  }
+  if (existRoutedWire(layerIdx, b, [&] (const Box<Int_t>& box, const UInt_t idx) {
+        return idx != netIdx;
+      }))
+    return false;
   // check blk
-  Vector_t<UInt_t> vBlkIndices;
-  _cir.querySpatialBlk(layerIdx, b, vBlkIndices);
-  for (const UInt_t idx : vBlkIndices) {
-    const Blk& blk = _cir.blk(idx);
-    if (!blk.bDummy())
-      return false;
-  }
+  if (_cir.existSpatialBlk(layerIdx, b, [&] (const Box<Int_t>& box, const UInt_t idx) {
+        return !_cir.blk(idx).bDummy();
+      }))
+    return false;
   return true;
 }
 
 bool DrcMgr::checkWireCutLayerShort(const UInt_t netIdx, const UInt_t layerIdx, const Box<Int_t>& b) const {
   // no pin in cut layers
   // check other net's wire (via)
-  Vector_t<UInt_t> vNetIndices;
-  Vector_t<Box<Int_t>> vBoxes;
-  _cir.querySpatialRoutedWire(layerIdx, b, vNetIndices, vBoxes);
-  for (const UInt_t idx : vNetIndices) {
-    if (idx != netIdx)
-      return false;
-  }
-  return true;
+  return !existRoutedWire(layerIdx, b, [&] (const Box<Int_t>& box, const UInt_t idx) {
+    return idx != netIdx;
+  });
 }
 
 // min area
@@ -94,61 +80,21 @@ bool DrcMgr::checkWireRoutingLayerSpacing(const UInt_t netIdx, const UInt_t laye
   checkBox.expand(prlSpacing - 1);
   
   // check pin
-  Vector_t<UInt_t> vPinIndices;
-  _cir.querySpatialPin(layerIdx, checkBox, vPinIndices);
-  for (const UInt_t pinIdx : vPinIndices) {
-    const Pin& pin = _cir.pin(pinIdx);
-    if (pin.netIdx() != netIdx)
-      return false;
-    else {
-      // same net
-      //UInt_t i;
-      //const Box<Int_t>* cpBox;
-      //Pin_ForEachLayerBox(pin, layerIdx, cpBox, i) {
-        //const Box<Int_t>& box = *cpBox;
-        //if (Box<Int_t>::bConnect(box, checkBox)) {
-          //if (!Box<Int_t>::bConnect(box, b))
-            //return false;
-        //}
-      //}
-    }
-  }
+  if (_cir.existSpatialPin(layerIdx, checkBox, [&] (const Box<Int_t>& box, const UInt_t pinIdx) {
+        return _cir.pin(pinIdx).netIdx() != netIdx;
+      }))
+    return false;
   // check other net's wires
-  Vector_t<UInt_t> vNetIndices;
-  Vector_t<Box<Int_t>> vBoxes;
-  _cir.querySpatialRoutedWire(layerIdx, checkBox, vNetIndices, vBoxes);
-  assert(vNetIndices.size() == vBoxes.size());
-  for (Int_t i = 0; i < (Int_t)vNetIndices.size(); ++i) {
-    const UInt_t idx = vNetIndices[i];
-    if (idx != netIdx)
-      return false;
-    else {
-      // same net
-      //const auto& box = vBoxes[i];
-      //if (!Box<Int_t>::bConnect(box, b))
-        //return false;
-    }
-  }
-  // check blk
-  Vector_t<UInt_t> vBlkIndices;
-  _cir.querySpatialBlk(layerIdx, checkBox, vBlkIndices);
-  for (const UInt_t idx : vBlkIndices) {
-    const Blk& blk = _cir.blk(idx);
-    //if (!blk.bDummy()) {
-      //return false;
-    //}
-    if (blk.pinIdx() == MAX_UINT)
-      return false;
-    else {
-      const UInt_t blkNetIdx = _cir.pin(blk.pinIdx()).netIdx();
-      if (netIdx != blkNetIdx)
-        return false;
-      //else {
-        //if (!Box<Int_t>::bConnect(blk.box(), b))
-          //return false;
-      //}
-    }
-  }
+  if (existRoutedWire(layerIdx, checkBox, [&] (const Box<Int_t>& box, const UInt_t idx) {
+        return idx != netIdx;
+      }))
+    return false;
+  // check blk, blks of the same net are fine
+  if (_cir.existSpatialBlk(layerIdx, checkBox, [&] (const Box<Int_t>& box, const UInt_t idx) {
+        const Blk& blk = _cir.blk(idx);
+        return blk.pinIdx() == MAX_UINT or _cir.pin(blk.pinIdx()).netIdx() != netIdx;
+      }))
+    return false;
   return true;
 }
 
@@ -163,14 +109,9 @@ bool DrcMgr::checkWireCutLayerSpacing(const UInt_t netIdx, const UInt_t layerIdx
   
   // no pin in cut layers
   // check other net's wire (via)
-  Vector_t<UInt_t> vNetIndices;
-  Vector_t<Box<Int_t>> vBoxes;
-  _cir.querySpatialRoutedWire(layerIdx, checkBox, vNetIndices, vBoxes);
-  for (const UInt_t idx : vNetIndices) {
-    if (idx != netIdx)
-      return false;
-  }
-  return true;
+  return !existRoutedWire(layerIdx, checkBox, [&] (const Box<Int_t>& box, const UInt_t idx) {
+    return idx != netIdx;
+  });
 }
 
 bool DrcMgr::checkWireEolSpacing(const UInt_t netIdx, const UInt_t layerIdx, const Box<Int_t>& b) const {
@@ -218,12 +159,10 @@ void DrcMgr::addNetShapesBFS(const Int_t netIdx, Vector_t<Vector_t<Box<Int_t>>>&
     qBlkIndices.pop();
     exploredSet.emplace(blk.idx());
     vvBoxes[blk.layerIdx()].emplace_back(blk.box());
-    Vector_t<UInt_t> vBlkIndices;
-    _cir.querySpatialBlk(blk.layerIdx(), blk.box(), vBlkIndices);
-    for (const UInt_t idx : vBlkIndices) {
+    _cir.vSpatialBlks()[blk.layerIdx()].visit(blk.box(), [&] (const Box<Int_t>& box, const UInt_t idx) {
       if (exploredSet.find(idx) == exploredSet.end())
         qBlkIndices.emplace(idx);
-    }
+    });
   }
 }
 
@@ -302,60 +241,30 @@ bool DrcMgr::checkSameNetRoutingLayerSpacing(const UInt_t netIdx) const {
           assert(seg.xl() != seg.xh() and seg.yl() == seg.yh());
           checkBox.shrinkX(1);
           checkBox.expandY(spacing - 1);
-          Vector_t<Segment<Int_t>> vSegs;
-          spatialSegs.query(checkBox, vSegs);
-          for (const auto& qs : vSegs) {
-            if (qs.bVertical())
-              continue;
-            if (!Segment<Int_t>::bConnect(qs, seg)
-                and !bCanPatch(i, qs, seg)) {
-              Segment<Int_t> centerConnectLine(qs.center(), seg.center());
-              const auto& checkPt = centerConnectLine.center();
-                //cerr << qs << seg << endl;
-                //for (const auto& polygon : vPolygons) {
-                  //const auto& ring = polygon.outer();
-                  //for (j = 0; j < ring.size(); ++j) {
-                    //const auto& pt0 = ring[j];
-                    //const auto& pt1 = j + 1 == ring.size() ? ring[0] : ring[j + 1];
-                    //cerr << pt0 << pt1 << endl;
-                  //}
-                  //cerr << endl;
-                //}
-                //exit(0);
-              if (!boost::polygon::contains(polygon, checkPt))
-                return false;
-            }
-          }
+          if (spatialSegs.exist(checkBox, [&] (const Box<Int_t>& qb, const Segment<Int_t>& qs) {
+                if (qs.bVertical()
+                    or Segment<Int_t>::bConnect(qs, seg)
+                    or bCanPatch(i, qs, seg))
+                  return false;
+                Segment<Int_t> centerConnectLine(qs.center(), seg.center());
+                return !boost::polygon::contains(polygon, centerConnectLine.center());
+              }))
+            return false;
         }
         else {
           assert(seg.bVertical());
           assert(seg.xl() == seg.xh() and seg.yl() != seg.yh());
           checkBox.shrinkY(1);
           checkBox.expandX(spacing - 1);
-          Vector_t<Segment<Int_t>> vSegs;
-          spatialSegs.query(checkBox, vSegs);
-          for (const auto& qs : vSegs) {
-            if (qs.bHorizontal())
-              continue;
-            if (!Segment<Int_t>::bConnect(qs, seg)
-                and !bCanPatch(i, qs, seg)) {
-              Segment<Int_t> centerConnectLine(qs.center(), seg.center());
-              const auto& checkPt = centerConnectLine.center();
-                //cerr << qs << seg << endl;
-                //for (const auto& polygon : vPolygons) {
-                  //const auto& ring = polygon.outer();
-                  //for (j = 0; j < ring.size(); ++j) {
-                    //const auto& pt0 = ring[j];
-                    //const auto& pt1 = j + 1 == ring.size() ? ring[0] : ring[j + 1];
-                    //cerr << pt0 << pt1 << endl;
-                  //}
-                  //cerr << endl;
-                //}
-                //exit(0);
-              if (!boost::polygon::contains(polygon, checkPt))
-                return false;
-            }
-          }
+          if (spatialSegs.exist(checkBox, [&] (const Box<Int_t>& qb, const Segment<Int_t>& qs) {
+                if (qs.bHorizontal()
+                    or Segment<Int_t>::bConnect(qs, seg)
+                    or bCanPatch(i, qs, seg))
+                  return false;
+                Segment<Int_t> centerConnectLine(qs.center(), seg.center());
+                return !boost::polygon::contains(polygon, centerConnectLine.center());
+              }))
+            return false;
         }
       }
     }
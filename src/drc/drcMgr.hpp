@@ -22,7 +22,11 @@ class DrcMgr {
  public:
   DrcMgr(CirDB& c)
     : _cir(c), _vSpatialPins(c.vSpatialPins()), _vSpatialBlks(c.vSpatialBlks()),
-      _vSpatialRoutedWires(c.vSpatialRoutedWires()) {}
+      _spatialRoutedWires(c.spatialRoutedWires()) {}
+  // check against the routed wires of a snapshot instead of the live ones
+  DrcMgr(CirDB& c, const RoutedWireStore::SnapshotPtr& pRoutedWires)
+    : _cir(c), _vSpatialPins(c.vSpatialPins()), _vSpatialBlks(c.vSpatialBlks()),
+      _spatialRoutedWires(c.spatialRoutedWires()), _pRoutedWires(pRoutedWires) {}
   ~DrcMgr() {}
 
   // return true: no violation ; false : violation
@@ -51,10 +55,16 @@ class DrcMgr {
   CirDB& _cir;
   const Vector_t<SpatialMap<Int_t, UInt_t>>&  _vSpatialPins;
   const Vector_t<SpatialMap<Int_t, UInt_t>>&  _vSpatialBlks;
-  const Vector_t<SpatialMap<Int_t, UInt_t>>&  _vSpatialRoutedWires;
+  const RoutedWireStore&                      _spatialRoutedWires;
+  RoutedWireStore::SnapshotPtr                _pRoutedWires; // null: the live routed wires
 
   void addNetShapesBFS(const Int_t netIdx, Vector_t<Vector_t<Box<Int_t>>>& vvBoxes) const;
   bool bCanPatch(const Int_t layerIdx, const Segment<Int_t>& s1, const Segment<Int_t>& s2) const;
+  template<typename Pred>
+  bool existRoutedWire(const UInt_t layerIdx, const Box<Int_t>& box, Pred pred) const {
+    return _pRoutedWires ? _pRoutedWires->layer(layerIdx).exist(box, pred)
+                         : _cir.existSpatialRoutedWire(layerIdx, box, pred);
+  }
   
 
 };
@@ -35,6 +35,86 @@ using PairingHeap = __gnu_pbds::priority_queue<T, Cmp, __gnu_pbds::pairing_heap_
 template<typename T, typename Cmp = std::less<T> >
 using ThinHeap = __gnu_pbds::priority_queue<T, Cmp, __gnu_pbds::thin_heap_tag>;
 
+// !!!!!!!! MIN HEAP
+
+// Binary heap of T* ordered by an integer key.
+// T keeps its own position through heapIdx() / setHeapIdx() (-1: not in heap),
+// so updating a key needs no iterator map.
+template<typename T, typename Key = std::int64_t>
+class IndexedHeap {
+ public:
+  IndexedHeap() {}
+  ~IndexedHeap() {}
+
+  bool    empty() const { return _vHeap.empty(); }
+  size_t  size()  const { return _vHeap.size(); }
+  T*      top()   const { return _vHeap.front().second; }
+
+  // insert p, or move it to its new key if it is already in the heap
+  void update(T* p, const Key key) {
+    Int_t i = p->heapIdx();
+    if (i < 0) {
+      i = _vHeap.size();
+      _vHeap.emplace_back(key, p);
+      p->setHeapIdx(i);
+      siftUp(i);
+    }
+    else if (key < _vHeap[i].first) {
+      _vHeap[i].first = key;
+      siftUp(i);
+    }
+    else {
+      _vHeap[i].first = key;
+      siftDown(i);
+    }
+  }
+
+  void pop() {
+    _vHeap.front().second->setHeapIdx(-1);
+    if (_vHeap.size() > 1) {
+      place(0, _vHeap.back());
+      _vHeap.pop_back();
+      siftDown(0);
+    }
+    else {
+      _vHeap.pop_back();
+    }
+  }
+
+ private:
+  Vector_t<Pair_t<Key, T*>> _vHeap;
+
+  void place(const Int_t i, const Pair_t<Key, T*>& e) {
+    _vHeap[i] = e;
+    e.second->setHeapIdx(i);
+  }
+  void siftUp(Int_t i) {
+    const Pair_t<Key, T*> e = _vHeap[i];
+    while (i > 0) {
+      const Int_t parent = (i - 1) / 2;
+      if (!(e.first < _vHeap[parent].first))
+        break;
+      place(i, _vHeap[parent]);
+      i = parent;
+    }
+    place(i, e);
+  }
+  void siftDown(Int_t i) {
+    const Pair_t<Key, T*> e = _vHeap[i];
+    const Int_t n = _vHeap.size();
+    while (2 * i + 1 < n) {
+      Int_t child = 2 * i + 1;
+      if (child + 1 < n and _vHeap[child + 1].first < _vHeap[child].first)
+        ++child;
+      if (!(_vHeap[child].first < e.first))
+        break;
+      place(i, _vHeap[child]);
+      i = child;
+    }
+    place(i, e);
+  }
+};
+
 PROJECT_NAMESPACE_END
 
 #endif /// _DS_PQUEUE_HPP_
@@ -0,0 +1,189 @@
+/**
+ * @file   binGrid.hpp
+ * @brief  Geometric Data Structure: 2D spatial type (Uniform Bin Grid Kernel)
+ *
+ **/
+
+#ifndef _GEO_BIN_GRID_HPP_
+#define _GEO_BIN_GRID_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/box.hpp"
+
+PROJECT_NAMESPACE_START
+
+// Boxes with values on a uniform grid of square bins. A box is stored in
+// every bin it touches (boxes outside the bound go to the border bins), so
+// insert and erase only touch those bins and never rebalance anything.
+// A query scans the bins under the query box and reports a box from the
+// bin holding the lower-left corner of the intersection only, so nothing
+// is reported twice and nothing is allocated.
+// Meant for many small boxes that come and go, e.g. routed wires.
+// Queries follow QueryType::intersects (touching boundaries count).
+template<typename T, typename Value>
+class BinGridMap {
+ public:
+  BinGridMap()
+    : _xl(0), _yl(0), _binSize(1), _numBinsX(0), _numBinsY(0), _size(0) {}
+  ~BinGridMap() {}
+
+  void init(const Box<T>& bound, const T binSize) {
+    assert(binSize > 0);
+    _xl = bound.xl();
+    _yl = bound.yl();
+    _binSize = binSize;
+    _numBinsX = bound.width() / binSize + 1;
+    _numBinsY = bound.height() / binSize + 1;
+    _vvBins.assign(_numBinsX * _numBinsY, Vector_t<Entry>());
+    _vHandleBoxes.clear();
+    _vFreeHandles.clear();
+    _size = 0;
+  }
+
+  // get
+  bool    empty() const { return _size == 0; }
+  size_t  size()  const { return _size; }
+
+  // set
+  void clear() {
+    for (Vector_t<Entry>& vEntries : _vvBins) {
+      vEntries.clear();
+    }
+    _vHandleBoxes.clear();
+    _vFreeHandles.clear();
+    _size = 0;
+  }
+
+  void insert(const Box<T>& rect, const Value& val) {
+    assert(!_vvBins.empty());
+    UInt_t handle;
+    if (!_vFreeHandles.empty()) {
+      handle = _vFreeHandles.back();
+      _vFreeHandles.pop_back();
+      _vHandleBoxes[handle] = rect;
+    }
+    else {
+      handle = _vHandleBoxes.size();
+      _vHandleBoxes.emplace_back(rect);
+    }
+    for (Int_t y = binY(rect.yl()); y <= binY(rect.yh()); ++y) {
+      for (Int_t x = binX(rect.xl()); x <= binX(rect.xh()); ++x) {
+        _vvBins[y * _numBinsX + x].push_back({rect, val, handle});
+      }
+    }
+    ++_size;
+  }
+
+  // erase one copy of (rect, val), false if there is none
+  bool erase(const Box<T>& rect, const Value& val) {
+    if (_vvBins.empty())
+      return false;
+    for (const Entry& e : _vvBins[binY(rect.yl()) * _numBinsX + binX(rect.xl())]) {
+      if (e.box == rect and e.val == val) {
+        erase(e.handle);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // query
+  // visitor(const Box<T>&, const Value&) is called once on every box touching rect
+  template<typename Visitor>
+  void visit(const Box<T>& rect, Visitor visitor) const {
+    forEach(rect, [&] (const Entry& e) { visitor(e.box, e.val); return false; });
+  }
+  // true if a box touching rect satisfies pred(const Box<T>&, const Value&), stop at the first one
+  template<typename Pred>
+  bool exist(const Box<T>& rect, Pred pred) const {
+    return forEach(rect, [&] (const Entry& e) { return pred(e.box, e.val); });
+  }
+  bool exist(const Box<T>& rect) const {
+    return forEach(rect, [] (const Entry& e) { return true; });
+  }
+  bool exist(const Point<T>& min_corner, const Point<T>& max_corner) const {
+    return exist(Box<T>(min_corner, max_corner));
+  }
+  size_t count(const Box<T>& rect) const {
+    size_t cnt = 0;
+    forEach(rect, [&] (const Entry& e) { ++cnt; return false; });
+    return cnt;
+  }
+  void queryBoth(const Box<T>& rect, Vector_t<Pair_t<Box<T>, Value>>& ret) const {
+    forEach(rect, [&] (const Entry& e) { ret.emplace_back(e.box, e.val); return false; });
+  }
+  void queryBoth(const Point<T>& min_corner, const Point<T>& max_corner, Vector_t<Pair_t<Box<T>, Value>>& ret) const {
+    queryBoth(Box<T>(min_corner, max_corner), ret);
+  }
+
+ private:
+  struct Entry {
+    Box<T>  box;
+    Value   val;
+    UInt_t  handle;
+  };
+
+  T                         _xl;
+  T                         _yl;
+  T                         _binSize;
+  Int_t                     _numBinsX;
+  Int_t                     _numBinsY;
+  size_t                    _size;
+  Vector_t<Vector_t<Entry>> _vvBins;        // [y * numBinsX + x]
+  Vector_t<Box<T>>          _vHandleBoxes;  // box of each handle
+  Vector_t<UInt_t>          _vFreeHandles;
+
+  Int_t binX(const T x) const {
+    return std::min(std::max((Int_t)((x - _xl) / _binSize), 0), _numBinsX - 1);
+  }
+  Int_t binY(const T y) const {
+    return std::min(std::max((Int_t)((y - _yl) / _binSize), 0), _numBinsY - 1);
+  }
+
+  // the handle tells the copies of one box apart in every bin it touches
+  void erase(const UInt_t handle) {
+    const Box<T> rect = _vHandleBoxes[handle];
+    for (Int_t y = binY(rect.yl()); y <= binY(rect.yh()); ++y) {
+      for (Int_t x = binX(rect.xl()); x <= binX(rect.xh()); ++x) {
+        Vector_t<Entry>& vEntries = _vvBins[y * _numBinsX + x];
+        for (UInt_t i = 0; i < vEntries.size(); ++i) {
+          if (vEntries[i].handle == handle) {
+            vEntries[i] = vEntries.back();
+            vEntries.pop_back();
+            break;
+          }
+        }
+      }
+    }
+    _vFreeHandles.emplace_back(handle);
+    --_size;
+  }
+
+  // run f on every box touching rect until it returns true
+  template<typename F>
+  bool forEach(const Box<T>& rect, F f) const {
+    if (_vvBins.empty())
+      return false;
+    const Int_t xl = binX(rect.xl()), xh = binX(rect.xh());
+    const Int_t yl = binY(rect.yl()), yh = binY(rect.yh());
+    for (Int_t y = yl; y <= yh; ++y) {
+      for (Int_t x = xl; x <= xh; ++x) {
+        for (const Entry& e : _vvBins[y * _numBinsX + x]) {
+          const Box<T>& b = e.box;
+          if (b.xl() > rect.xh() or rect.xl() > b.xh() or b.yl() > rect.yh() or rect.yl() > b.yh())
+            continue;
+          // report from the bin of the lower-left corner of the intersection only
+          if (binX(std::max(b.xl(), rect.xl())) != x or binY(std::max(b.yl(), rect.yl())) != y)
+            continue;
+          if (f(e))
+            return true;
+        }
+      }
+    }
+    return false;
+  }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _GEO_BIN_GRID_HPP_
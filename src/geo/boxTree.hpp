@@ -0,0 +1,144 @@
+/**
+ * @file   boxTree.hpp
+ * @brief  Geometric Data Structure: static box tree for point queries
+ *
+ **/
+
+#ifndef _GEO_BOX_TREE_HPP_
+#define _GEO_BOX_TREE_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/box.hpp"
+
+PROJECT_NAMESPACE_START
+
+// A fixed set of boxes split at the median of their centers, every node
+// keeping the bounding box of its boxes. Built once, then answers
+// "is the point inside a box" and "weighted manhattan distance to the
+// nearest box" by pruning whole subtrees, without allocating.
+template<typename T>
+class BoxTree {
+ public:
+  BoxTree() {}
+  ~BoxTree() {}
+
+  // takes the boxes over
+  void build(Vector_t<Box<T>>& vBoxes) {
+    _vBoxes.swap(vBoxes);
+    _vNodes.clear();
+    if (_vBoxes.empty())
+      return;
+    Int_t numNodes = 1;
+    while (numNodes * kLeafSize < (Int_t)_vBoxes.size()) {
+      numNodes *= 2;
+    }
+    _vNodes.resize(2 * numNodes - 1);
+    buildNode(0, 0, _vBoxes.size());
+  }
+
+  bool    empty() const { return _vBoxes.empty(); }
+  size_t  size()  const { return _vBoxes.size(); }
+
+  // true if (x, y) is inside or on a box
+  bool exist(const T x, const T y) const {
+    return !_vBoxes.empty() and existNode(0, x, y);
+  }
+
+  // min of wx * dx + wy * dy from (x, y) to the boxes, bound if none is closer
+  T nearestDist(const T x, const T y, const T wx, const T wy, const T bound) const {
+    T best = bound;
+    if (!_vBoxes.empty())
+      nearestNode(0, x, y, wx, wy, best);
+    return best;
+  }
+
+ private:
+  static constexpr Int_t kLeafSize = 4;
+
+  struct Node {
+    Box<T>  bbox;
+    UInt_t  begin = 0;
+    UInt_t  end = 0; // leaf if children are empty
+  };
+
+  Vector_t<Box<T>>  _vBoxes;
+  Vector_t<Node>    _vNodes; // children of i at 2i+1, 2i+2
+
+  void buildNode(const UInt_t i, const UInt_t begin, const UInt_t end) {
+    Node& node = _vNodes[i];
+    node.begin = begin;
+    node.end = end;
+    node.bbox = _vBoxes[begin];
+    for (UInt_t j = begin + 1; j < end; ++j) {
+      node.bbox.setBounds(std::min(node.bbox.xl(), _vBoxes[j].xl()), std::min(node.bbox.yl(), _vBoxes[j].yl()),
+                          std::max(node.bbox.xh(), _vBoxes[j].xh()), std::max(node.bbox.yh(), _vBoxes[j].yh()));
+    }
+    if ((Int_t)(end - begin) <= kLeafSize or 2 * i + 2 >= _vNodes.size())
+      return;
+    // split the wider side at the median center
+    const UInt_t mid = begin + (end - begin) / 2;
+    if (node.bbox.width() >= node.bbox.height()) {
+      std::nth_element(_vBoxes.begin() + begin, _vBoxes.begin() + mid, _vBoxes.begin() + end,
+                       [] (const Box<T>& a, const Box<T>& b) { return a.xl() + a.xh() < b.xl() + b.xh(); });
+    }
+    else {
+      std::nth_element(_vBoxes.begin() + begin, _vBoxes.begin() + mid, _vBoxes.begin() + end,
+                       [] (const Box<T>& a, const Box<T>& b) { return a.yl() + a.yh() < b.yl() + b.yh(); });
+    }
+    buildNode(2 * i + 1, begin, mid);
+    buildNode(2 * i + 2, mid, end);
+  }
+
+  bool bLeaf(const UInt_t i) const {
+    return 2 * i + 1 >= _vNodes.size() or _vNodes[2 * i + 1].end == 0;
+  }
+
+  static bool bInside(const Box<T>& b, const T x, const T y) {
+    return b.xl() <= x and x <= b.xh() and b.yl() <= y and y <= b.yh();
+  }
+
+  static T dist(const Box<T>& b, const T x, const T y, const T wx, const T wy) {
+    return std::max(std::max(b.xl() - x, x - b.xh()), (T)0) * wx
+         + std::max(std::max(b.yl() - y, y - b.yh()), (T)0) * wy;
+  }
+
+  bool existNode(const UInt_t i, const T x, const T y) const {
+    const Node& node = _vNodes[i];
+    if (!bInside(node.bbox, x, y))
+      return false;
+    if (bLeaf(i)) {
+      for (UInt_t j = node.begin; j < node.end; ++j) {
+        if (bInside(_vBoxes[j], x, y))
+          return true;
+      }
+      return false;
+    }
+    return existNode(2 * i + 1, x, y) or existNode(2 * i + 2, x, y);
+  }
+
+  void nearestNode(const UInt_t i, const T x, const T y, const T wx, const T wy, T& best) const {
+    const Node& node = _vNodes[i];
+    if (bLeaf(i)) {
+      for (UInt_t j = node.begin; j < node.end; ++j) {
+        best = std::min(best, dist(_vBoxes[j], x, y, wx, wy));
+      }
+      return;
+    }
+    // closer child first, the other one only if it can still be closer
+    UInt_t near = 2 * i + 1, far = 2 * i + 2;
+    T nearDist = dist(_vNodes[near].bbox, x, y, wx, wy);
+    T farDist = dist(_vNodes[far].bbox, x, y, wx, wy);
+    if (farDist < nearDist) {
+      std::swap(near, far);
+      std::swap(nearDist, farDist);
+    }
+    if (nearDist < best)
+      nearestNode(near, x, y, wx, wy, best);
+    if (farDist < best)
+      nearestNode(far, x, y, wx, wy, best);
+  }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _GEO_BOX_TREE_HPP_
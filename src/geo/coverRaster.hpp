@@ -0,0 +1,108 @@
+/**
+ * @file   coverRaster.hpp
+ * @brief  Geometric Data Structure: per-layer coverage counts on a uniform grid
+ *
+ **/
+
+#ifndef _GEO_COVER_RASTER_HPP_
+#define _GEO_COVER_RASTER_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/box.hpp"
+#include "src/geo/cowGrid.hpp"
+
+PROJECT_NAMESPACE_START
+
+// Each layer is cut into square cells. A cell counts the inserted boxes
+// (bloated by the layer clearance) that touch it, so a box whose cells are
+// all zero is farther than the clearance from every inserted shape.
+// Boxes outside the raster are clamped to the border cells.
+// The cells are stored in copy-on-write tiles, so a copy of the raster is
+// cheap and an update only copies the tiles it touches.
+class CoverRaster {
+ public:
+  CoverRaster()
+    : _xl(0), _yl(0), _cellSize(1), _numCellsX(0), _numCellsY(0) {}
+  ~CoverRaster() {}
+
+  void init(const Box<Int_t>& bound, const Int_t cellSize, const Vector_t<Int_t>& vClearances) {
+    assert(cellSize > 0);
+    _xl = bound.xl();
+    _yl = bound.yl();
+    _cellSize = cellSize;
+    _numCellsX = bound.width() / cellSize + 1;
+    _numCellsY = bound.height() / cellSize + 1;
+    _vClearances = vClearances;
+    _vGrids.assign(vClearances.size(), CowGrid<Vector_t<Int_t>>());
+    for (CowGrid<Vector_t<Int_t>>& grid : _vGrids) {
+      grid.init((_numCellsX + kTileCells - 1) / kTileCells, (_numCellsY + kTileCells - 1) / kTileCells,
+                [] (const Int_t x, const Int_t y) { return Vector_t<Int_t>(kTileCells * kTileCells, 0); });
+    }
+  }
+
+  bool  bInit()                             const { return !_vGrids.empty(); }
+  Int_t clearance(const Int_t layerIdx)     const { return _vClearances[layerIdx]; }
+
+  void insert(const Int_t layerIdx, const Box<Int_t>& box) { update(layerIdx, box, 1); }
+  void erase(const Int_t layerIdx, const Box<Int_t>& box)  { update(layerIdx, box, -1); }
+
+  // true: no inserted shape within the clearance of box
+  bool bClean(const Int_t layerIdx, const Box<Int_t>& box) const {
+    const CowGrid<Vector_t<Int_t>>& grid = _vGrids[layerIdx];
+    const Int_t xl = cellX(box.xl()), xh = cellX(box.xh());
+    const Int_t yl = cellY(box.yl()), yh = cellY(box.yh());
+    for (Int_t ty = yl / kTileCells; ty <= yh / kTileCells; ++ty) {
+      for (Int_t tx = xl / kTileCells; tx <= xh / kTileCells; ++tx) {
+        const Vector_t<Int_t>& vCounts = grid.tile(tx, ty);
+        for (Int_t y = std::max(yl, ty * kTileCells); y <= std::min(yh, ty * kTileCells + kTileCells - 1); ++y) {
+          for (Int_t x = std::max(xl, tx * kTileCells); x <= std::min(xh, tx * kTileCells + kTileCells - 1); ++x) {
+            if (vCounts[(y % kTileCells) * kTileCells + x % kTileCells] != 0)
+              return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  static constexpr Int_t kTileCells = 32; // cells per tile side
+
+  Int_t                               _xl;
+  Int_t                               _yl;
+  Int_t                               _cellSize;
+  Int_t                               _numCellsX;
+  Int_t                               _numCellsY;
+  Vector_t<Int_t>                     _vClearances; // bloat of the inserted boxes in each layer
+  Vector_t<CowGrid<Vector_t<Int_t>>>  _vGrids;      // counts of kTileCells x kTileCells cells per tile
+
+  Int_t cellX(const Int_t x) const {
+    return std::min(std::max((x - _xl) / _cellSize, 0), _numCellsX - 1);
+  }
+  Int_t cellY(const Int_t y) const {
+    return std::min(std::max((y - _yl) / _cellSize, 0), _numCellsY - 1);
+  }
+
+  void update(const Int_t layerIdx, const Box<Int_t>& box, const Int_t d) {
+    CowGrid<Vector_t<Int_t>>& grid = _vGrids[layerIdx];
+    const Int_t c = _vClearances[layerIdx];
+    const Int_t xl = cellX(box.xl() - c), xh = cellX(box.xh() + c);
+    const Int_t yl = cellY(box.yl() - c), yh = cellY(box.yh() + c);
+    for (Int_t ty = yl / kTileCells; ty <= yh / kTileCells; ++ty) {
+      for (Int_t tx = xl / kTileCells; tx <= xh / kTileCells; ++tx) {
+        Vector_t<Int_t>& vCounts = grid.writableTile(tx, ty);
+        for (Int_t y = std::max(yl, ty * kTileCells); y <= std::min(yh, ty * kTileCells + kTileCells - 1); ++y) {
+          for (Int_t x = std::max(xl, tx * kTileCells); x <= std::min(xh, tx * kTileCells + kTileCells - 1); ++x) {
+            Int_t& cnt = vCounts[(y % kTileCells) * kTileCells + x % kTileCells];
+            cnt += d;
+            assert(cnt >= 0);
+          }
+        }
+      }
+    }
+  }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _GEO_COVER_RASTER_HPP_
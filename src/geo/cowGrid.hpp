@@ -0,0 +1,82 @@
+/**
+ * @file   cowGrid.hpp
+ * @brief  Geometric Data Structure: copy-on-write grid of tiles
+ *
+ **/
+
+#ifndef _GEO_COW_GRID_HPP_
+#define _GEO_COW_GRID_HPP_
+
+#include "src/global/global.hpp"
+
+#include <atomic>
+#include <memory>
+
+PROJECT_NAMESPACE_START
+
+// A 2D grid of tiles kept as rows of shared tiles. Copying the grid copies
+// one pointer and shares every row and tile. Writing a tile first copies
+// whatever is still shared on its path: the row array, the tile's row and
+// the tile itself, so a write costs O(numTilesX + numTilesY + tile) however
+// large the grid, and the copies never see each other's writes.
+// A copy may be read from any thread while the grid it came from is
+// written; only the writer may copy from or write to a grid.
+template<typename Tile>
+class CowGrid {
+ public:
+  CowGrid()
+    : _numTilesX(0), _numTilesY(0) {}
+  ~CowGrid() {}
+
+  // newTile(x, y) returns the initial tile at (x, y)
+  template<typename Factory>
+  void init(const Int_t numTilesX, const Int_t numTilesY, Factory newTile) {
+    _numTilesX = numTilesX;
+    _numTilesY = numTilesY;
+    std::shared_ptr<Rows> pRows = std::make_shared<Rows>();
+    for (Int_t y = 0; y < numTilesY; ++y) {
+      std::shared_ptr<Row> pRow = std::make_shared<Row>();
+      for (Int_t x = 0; x < numTilesX; ++x) {
+        pRow->emplace_back(std::make_shared<Tile>(newTile(x, y)));
+      }
+      pRows->emplace_back(std::move(pRow));
+    }
+    _pRows = std::move(pRows);
+  }
+
+  // get
+  bool        bInit()                               const { return _pRows != nullptr; }
+  Int_t       numTilesX()                           const { return _numTilesX; }
+  Int_t       numTilesY()                           const { return _numTilesY; }
+  const Tile& tile(const Int_t x, const Int_t y)    const { return *(*(*_pRows)[y])[x]; }
+
+  // set
+  Tile& writableTile(const Int_t x, const Int_t y) {
+    Rows& vpRows = unshare(_pRows);
+    Row& vpTiles = unshare(vpRows[y]);
+    return unshare(vpTiles[x]);
+  }
+
+ private:
+  typedef Vector_t<std::shared_ptr<Tile>> Row;
+  typedef Vector_t<std::shared_ptr<Row>>  Rows;
+
+  Int_t                 _numTilesX;
+  Int_t                 _numTilesY;
+  std::shared_ptr<Rows> _pRows;
+
+  // only the writer can add owners, so a count of 1 stays 1; the fence
+  // orders this write after the reads of the copy that released it last
+  template<typename T>
+  static T& unshare(std::shared_ptr<T>& p) {
+    if (p.use_count() > 1)
+      p = std::make_shared<T>(*p);
+    else
+      std::atomic_thread_fence(std::memory_order_acquire);
+    return *p;
+  }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _GEO_COW_GRID_HPP_
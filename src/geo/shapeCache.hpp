@@ -0,0 +1,157 @@
+/**
+ * @file   shapeCache.hpp
+ * @brief  Geometric Data Structure: per-layer boxes in lazily loaded tiled structure-of-arrays buffers
+ *
+ **/
+
+#ifndef _GEO_SHAPE_CACHE_HPP_
+#define _GEO_SHAPE_CACHE_HPP_
+
+#include "src/global/global.hpp"
+#include "src/geo/box.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+PROJECT_NAMESPACE_START
+
+// The boxes around a bound, loaded tile by tile. The bound is cut into
+// square tiles; the first query touching a tile of a layer asks the loader
+// for the boxes touching that tile and appends their coordinates to the
+// contiguous arrays of the layer (a box is repeated in every tile it
+// touches), so an overlap query scans a few short arrays, eight boxes at a
+// time with AVX2, and only the tiles a search actually reaches are loaded.
+// Queries of loaded tiles do not allocate.
+class ShapeCache {
+ public:
+  ShapeCache()
+    : _tileSize(1), _numTilesX(0), _numTilesY(0) {}
+  ~ShapeCache() {}
+
+  void init(const Int_t numLayers, const Box<Int_t>& bound, const Int_t tileSize) {
+    assert(tileSize > 0);
+    _bound = bound;
+    _tileSize = tileSize;
+    _numTilesX = bound.width() / tileSize + 1;
+    _numTilesY = bound.height() / tileSize + 1;
+    _vLayers.resize(numLayers);
+    for (Layer& layer : _vLayers) {
+      layer.vTiles.clear();
+      layer.vXl.clear();
+      layer.vYl.clear();
+      layer.vXh.clear();
+      layer.vYh.clear();
+    }
+  }
+
+  // reload the tiles of a layer touching box on their next query, after the source changed there
+  void invalidate(const Int_t layerIdx, const Box<Int_t>& box) {
+    Layer& layer = _vLayers[layerIdx];
+    if (layer.vTiles.empty() or !Box<Int_t>::bConnect(_bound, box))
+      return;
+    for (Int_t y = tileY(box.yl()); y <= tileY(box.yh()); ++y) {
+      for (Int_t x = tileX(box.xl()); x <= tileX(box.xh()); ++x) {
+        layer.vTiles[y * _numTilesX + x].first = -1;
+      }
+    }
+  }
+
+  const Box<Int_t>& bound() const { return _bound; }
+  // true: every box touching box is in the cache
+  bool bCover(const Box<Int_t>& box) const { return !_vLayers.empty() and Box<Int_t>::bCover(_bound, box); }
+
+  // true: a box of the layer touches box (boundaries included), box inside the bound;
+  // load(layerIdx, tileBox, vBoxes) appends the boxes touching tileBox to vBoxes
+  template<typename Load>
+  bool bOverlap(const Int_t layerIdx, const Box<Int_t>& box, Load load) {
+    Layer& layer = _vLayers[layerIdx];
+    if (layer.vTiles.empty()) {
+      layer.vTiles.assign(_numTilesX * _numTilesY, Pair_t<Int_t, Int_t>(-1, -1));
+    }
+    for (Int_t y = tileY(box.yl()); y <= tileY(box.yh()); ++y) {
+      for (Int_t x = tileX(box.xl()); x <= tileX(box.xh()); ++x) {
+        Pair_t<Int_t, Int_t>& tile = layer.vTiles[y * _numTilesX + x];
+        if (tile.first < 0) {
+          loadTile(layerIdx, x, y, tile, load);
+        }
+        if (bOverlap(layer, tile.first, tile.second, box))
+          return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  struct Layer {
+    Vector_t<Pair_t<Int_t, Int_t>> vTiles; // boxes of tile i are [first, second), first < 0 if not loaded
+    Vector_t<Int_t> vXl;
+    Vector_t<Int_t> vYl;
+    Vector_t<Int_t> vXh;
+    Vector_t<Int_t> vYh;
+  };
+
+  Box<Int_t>        _bound;
+  Int_t             _tileSize;
+  Int_t             _numTilesX;
+  Int_t             _numTilesY;
+  Vector_t<Layer>   _vLayers;
+  Vector_t<Box<Int_t>> _vLoadBoxes;  // load buffer
+
+  template<typename Load>
+  void loadTile(const Int_t layerIdx, const Int_t x, const Int_t y, Pair_t<Int_t, Int_t>& tile, Load load) {
+    const Box<Int_t> tileBox(_bound.xl() + x * _tileSize,
+                             _bound.yl() + y * _tileSize,
+                             x == _numTilesX - 1 ? _bound.xh() : _bound.xl() + (x + 1) * _tileSize - 1,
+                             y == _numTilesY - 1 ? _bound.yh() : _bound.yl() + (y + 1) * _tileSize - 1);
+    _vLoadBoxes.clear();
+    load(layerIdx, tileBox, _vLoadBoxes);
+    Layer& layer = _vLayers[layerIdx];
+    tile.first = layer.vXl.size();
+    for (const Box<Int_t>& box : _vLoadBoxes) {
+      layer.vXl.emplace_back(box.xl());
+      layer.vYl.emplace_back(box.yl());
+      layer.vXh.emplace_back(box.xh());
+      layer.vYh.emplace_back(box.yh());
+    }
+    tile.second = layer.vXl.size();
+  }
+
+  Int_t tileX(const Int_t x) const {
+    return std::min(std::max((x - _bound.xl()) / _tileSize, 0), _numTilesX - 1);
+  }
+  Int_t tileY(const Int_t y) const {
+    return std::min(std::max((y - _bound.yl()) / _tileSize, 0), _numTilesY - 1);
+  }
+
+  static bool bOverlap(const Layer& layer, Int_t i, const Int_t end, const Box<Int_t>& box) {
+#ifdef __AVX2__
+    const __m256i xl = _mm256_set1_epi32(box.xl());
+    const __m256i yl = _mm256_set1_epi32(box.yl());
+    const __m256i xh = _mm256_set1_epi32(box.xh());
+    const __m256i yh = _mm256_set1_epi32(box.yh());
+    for (; i + 8 <= end; i += 8) {
+      const __m256i bxl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&layer.vXl[i]));
+      const __m256i byl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&layer.vYl[i]));
+      const __m256i bxh = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&layer.vXh[i]));
+      const __m256i byh = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&layer.vYh[i]));
+      // a lane is set if its box is strictly left, right, below or above box
+      __m256i apart = _mm256_or_si256(_mm256_cmpgt_epi32(bxl, xh), _mm256_cmpgt_epi32(xl, bxh));
+      apart = _mm256_or_si256(apart, _mm256_cmpgt_epi32(byl, yh));
+      apart = _mm256_or_si256(apart, _mm256_cmpgt_epi32(yl, byh));
+      if (_mm256_movemask_epi8(apart) != -1)
+        return true;
+    }
+#endif
+    for (; i < end; ++i) {
+      if (layer.vXl[i] <= box.xh() and box.xl() <= layer.vXh[i]
+          and layer.vYl[i] <= box.yh() and box.yl() <= layer.vYh[i])
+        return true;
+    }
+    return false;
+  }
+};
+
+PROJECT_NAMESPACE_END
+
+#endif /// _GEO_SHAPE_CACHE_HPP_
@@ -60,24 +60,6 @@ namespace spatial {
     void operator () (const T& t) { _ret.push_back(t); }
     Vector_t<T>& _ret;
   };
-  
-  template<typename BBox>
-  struct SearchCallback_first { // return b_value.first
-    SearchCallback_first(Vector_t<BBox>& ret)
-      : _ret(ret) {}
-    template<typename BValue>
-    void operator () (const BValue& bv) { _ret.push_back(bv.first); }
-    Vector_t<BBox>& _ret;
-  };
-  
-  template<typename Value>
-  struct SearchCallback_second { // return b_value.second
-    SearchCallback_second(Vector_t<Value>& ret)
-      : _ret(ret) {}
-    template<typename BValue>
-    void operator () (const BValue& bv) { _ret.push_back(bv.second); }
-    Vector_t<Value>& _ret;
-  };
 
   // Query options
   enum class QueryType {
@@ -89,6 +71,60 @@ namespace spatial {
     overlaps,
     within
   };
+
+  // stream every value satisfying qt against queryBox into callback
+  template<typename Rtree, typename BBox, typename Callback>
+  void queryRtree(const Rtree& rtree, const BBox& queryBox, Callback callback, QueryType qt) {
+    switch (qt) {
+      case QueryType::contains :
+        rtree.query(bgi::contains(queryBox), boost::make_function_output_iterator(callback)); break;
+      case QueryType::covered_by :
+        rtree.query(bgi::covered_by(queryBox), boost::make_function_output_iterator(callback)); break;
+      case QueryType::covers :
+        rtree.query(bgi::covers(queryBox), boost::make_function_output_iterator(callback)); break;
+      case QueryType::disjoint :
+        rtree.query(bgi::disjoint(queryBox), boost::make_function_output_iterator(callback)); break;
+      case QueryType::intersects :
+        rtree.query(bgi::intersects(queryBox), boost::make_function_output_iterator(callback)); break;
+      case QueryType::overlaps :
+        rtree.query(bgi::overlaps(queryBox), boost::make_function_output_iterator(callback)); break;
+      case QueryType::within :
+        rtree.query(bgi::within(queryBox), boost::make_function_output_iterator(callback)); break;
+      default:
+        assert(false);
+    }
+  }
+
+  // true if a value satisfying qt also satisfies pred.
+  // Once a hit is found every remaining value is rejected before it reaches
+  // pred, the traversal still visits the nodes touching queryBox.
+  // (The rtree query iterators would stop right away but allocate.)
+  template<typename Rtree, typename BBox, typename Pred>
+  bool existRtree(const Rtree& rtree, const BBox& queryBox, Pred pred, QueryType qt) {
+    typedef typename Rtree::value_type value_type;
+    bool bFound = false;
+    auto filter = bgi::satisfies([&] (const value_type& v) { return !bFound and pred(v); });
+    auto callback = boost::make_function_output_iterator([&] (const value_type& v) { bFound = true; });
+    switch (qt) {
+      case QueryType::contains :
+        rtree.query(bgi::contains(queryBox) && filter, callback); break;
+      case QueryType::covered_by :
+        rtree.query(bgi::covered_by(queryBox) && filter, callback); break;
+      case QueryType::covers :
+        rtree.query(bgi::covers(queryBox) && filter, callback); break;
+      case QueryType::disjoint :
+        rtree.query(bgi::disjoint(queryBox) && filter, callback); break;
+      case QueryType::intersects :
+        rtree.query(bgi::intersects(queryBox) && filter, callback); break;
+      case QueryType::overlaps :
+        rtree.query(bgi::overlaps(queryBox) && filter, callback); break;
+      case QueryType::within :
+        rtree.query(bgi::within(queryBox) && filter, callback); break;
+      default:
+        assert(false);
+    }
+    return bFound;
+  }
 }
 
 template<typename T>
@@ -101,6 +137,7 @@ public:
   Spatial() {}
   Spatial(const spatial::Rtree<T>& t) : _rtree(t) {}
   Spatial(const Spatial& sp) : _rtree(sp._rtree) {}
+  Spatial(Spatial&& sp) : _rtree(std::move(sp._rtree)) {}
   template<typename Container>
   Spatial(const Container &container) : _rtree(container) {} // use packing algorithm
   template<typename Container_Iterator>
@@ -113,6 +150,7 @@ public:
   
   // operators
   void operator = (const Spatial& sp) { _rtree = sp._rtree; }
+  void operator = (Spatial&& sp)      { _rtree = std::move(sp._rtree); } // e.g. take over a packed tree
   
   // get
   bool    empty() const { return _rtree.empty(); }
@@ -142,6 +180,14 @@ public:
   void    query(const Box<T>& rect, Vector_t<Box<T> >& ret, spatial::QueryType qt = spatial::QueryType::intersects) const;
   bool    exist(const Point<T>& min_corner, const Point<T>& max_corner, spatial::QueryType qt = spatial::QueryType::intersects) const;
   bool    exist(const Box<T>& rect, spatial::QueryType qt = spatial::QueryType::intersects) const;
+  size_t  count(const Box<T>& rect, spatial::QueryType qt = spatial::QueryType::intersects) const;
+
+  // allocation-free query: visitor(const Box<T>&) is called on every hit,
+  // pred(const Box<T>&) filters the hits of exist
+  template<typename Visitor>
+  void    visit(const Box<T>& rect, Visitor visitor, spatial::QueryType qt = spatial::QueryType::intersects) const;
+  template<typename Pred>
+  bool    exist(const Box<T>& rect, Pred pred, spatial::QueryType qt = spatial::QueryType::intersects) const;
 
   // kNN search
   void    nearestSearch(const Point<T>& pt, const UInt_t k, Vector_t<Box<T>>& ret);
@@ -159,6 +205,7 @@ public:
   SpatialMap() {}
   SpatialMap(const spatial::RtreeMap<T, Value>& t) : _rtreeMap(t) {}
   SpatialMap(const SpatialMap& sp) : _rtreeMap(sp._rtreeMap) {}
+  SpatialMap(SpatialMap&& sp) : _rtreeMap(std::move(sp._rtreeMap)) {}
   template<typename Container>
   SpatialMap(const Container &container) : _rtreeMap(container) {} // use packing algorithm
   template<typename Container_Iterator>
@@ -171,6 +218,7 @@ public:
   
   // operators
   void operator = (const SpatialMap& sp) { _rtreeMap = sp._rtreeMap; }
+  void operator = (SpatialMap&& sp)      { _rtreeMap = std::move(sp._rtreeMap); } // e.g. take over a packed tree
   
   // get
   bool    empty() const { return _rtreeMap.empty(); }
@@ -204,6 +252,14 @@ public:
   void    queryBoth(const Box<T>& rect, Vector_t<Pair_t<Box<T>, Value>>& ret, spatial::QueryType qt = spatial::QueryType::intersects) const;
   bool    exist(const Point<T>& min_corner, const Point<T>& max_corner, spatial::QueryType qt = spatial::QueryType::intersects) const;
   bool    exist(const Box<T>& rect, spatial::QueryType qt = spatial::QueryType::intersects) const;
+  size_t  count(const Box<T>& rect, spatial::QueryType qt = spatial::QueryType::intersects) const;
+
+  // allocation-free query: visitor(const Box<T>&, const Value&) is called on every hit,
+  // pred(const Box<T>&, const Value&) filters the hits of exist
+  template<typename Visitor>
+  void    visit(const Box<T>& rect, Visitor visitor, spatial::QueryType qt = spatial::QueryType::intersects) const;
+  template<typename Pred>
+  bool    exist(const Box<T>& rect, Pred pred, spatial::QueryType qt = spatial::QueryType::intersects) const;
 
   // kNN search
   void    nearestSearch(const Point<T>& pt, const UInt_t k, Vector_t<Value>& ret);
@@ -218,72 +274,46 @@ public:
 ////////// Spatial Implementation /////////////
 template<typename T>
 void Spatial<T>::query(const Point<T>& min_corner, const Point<T>& max_corner, Vector_t<Box<T> >& ret, spatial::QueryType qt) const {
-  Vector_t<spatial::b_box<T>> vTmp;
-  spatial::SearchCallback<spatial::b_box<T> > callback(vTmp);
-  spatial::b_box<T> query_box(min_corner, max_corner);
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtree.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtree.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtree.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtree.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtree.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtree.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtree.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
-  ret.reserve(vTmp.size());
-  for (const auto& b : vTmp)
-    ret.emplace_back(b.min_corner(), b.max_corner());
+  spatial::queryRtree(_rtree, spatial::b_box<T>(min_corner, max_corner),
+                      [&] (const spatial::b_box<T>& b) { ret.emplace_back(b.min_corner(), b.max_corner()); }, qt);
 }
 
 template<typename T>
 void Spatial<T>::query(const Box<T>& rect, Vector_t<Box<T> >& ret, spatial::QueryType qt) const {
-  Vector_t<spatial::b_box<T>> vTmp;
-  spatial::SearchCallback<spatial::b_box<T> > callback(vTmp);
-  spatial::b_box<T> query_box(rect.min_corner(), rect.max_corner());
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtree.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtree.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtree.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtree.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtree.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtree.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtree.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
-  ret.reserve(vTmp.size());
-  for (const auto& b : vTmp)
-    ret.emplace_back(b.min_corner(), b.max_corner());
+  query(rect.min_corner(), rect.max_corner(), ret, qt);
 }
 
 template<typename T>
 bool Spatial<T>::exist(const Point<T>& min_corner, const Point<T>& max_corner, spatial::QueryType qt) const {
-  Vector_t<Box<T>> ret;
-  query(min_corner, max_corner, ret, qt);
-  return !ret.empty();
+  return spatial::existRtree(_rtree, spatial::b_box<T>(min_corner, max_corner),
+                             [] (const spatial::b_box<T>& b) { return true; }, qt);
 }
 
 template<typename T>
 bool Spatial<T>::exist(const Box<T>& rect, spatial::QueryType qt) const {
-  Vector_t<Box<T>> ret;
-  query(rect, ret, qt);
-  return !ret.empty();
+  return exist(rect.min_corner(), rect.max_corner(), qt);
+}
+
+template<typename T>
+size_t Spatial<T>::count(const Box<T>& rect, spatial::QueryType qt) const {
+  size_t cnt = 0;
+  spatial::queryRtree(_rtree, spatial::b_box<T>(rect.min_corner(), rect.max_corner()),
+                      [&] (const spatial::b_box<T>& b) { ++cnt; }, qt);
+  return cnt;
+}
+
+template<typename T>
+template<typename Visitor>
+void Spatial<T>::visit(const Box<T>& rect, Visitor visitor, spatial::QueryType qt) const {
+  spatial::queryRtree(_rtree, spatial::b_box<T>(rect.min_corner(), rect.max_corner()),
+                      [&] (const spatial::b_box<T>& b) { visitor(Box<T>(b.min_corner(), b.max_corner())); }, qt);
+}
+
+template<typename T>
+template<typename Pred>
+bool Spatial<T>::exist(const Box<T>& rect, Pred pred, spatial::QueryType qt) const {
+  return spatial::existRtree(_rtree, spatial::b_box<T>(rect.min_corner(), rect.max_corner()),
+                             [&] (const spatial::b_box<T>& b) { return pred(Box<T>(b.min_corner(), b.max_corner())); }, qt);
 }
 
 template<typename T>
@@ -309,180 +339,74 @@ void Spatial<T>::nearestSearch(const Box<T>& box, const UInt_t k, Vector_t<Box<T
 ////////// SpatialMap Implementation /////////////
 template<typename T, typename Value>
 void SpatialMap<T, Value>::query(const Point<T>& min_corner, const Point<T>& max_corner, Vector_t<Value>& ret, spatial::QueryType qt) const {
-  spatial::SearchCallback_second<Value> callback(ret);
-  spatial::b_box<T> query_box(min_corner, max_corner);
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtreeMap.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtreeMap.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtreeMap.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtreeMap.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtreeMap.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtreeMap.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtreeMap.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
+  spatial::queryRtree(_rtreeMap, spatial::b_box<T>(min_corner, max_corner),
+                      [&] (const spatial::b_value<T, Value>& bv) { ret.push_back(bv.second); }, qt);
 }
 
 template<typename T, typename Value>
 void SpatialMap<T, Value>::query(const Box<T>& rect, Vector_t<Value>& ret, spatial::QueryType qt) const {
-  spatial::SearchCallback_second<Value> callback(ret);
-  spatial::b_box<T> query_box(rect.min_corner(), rect.max_corner());
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtreeMap.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtreeMap.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtreeMap.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtreeMap.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtreeMap.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtreeMap.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtreeMap.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
+  query(rect.min_corner(), rect.max_corner(), ret, qt);
 }
 
 template<typename T, typename Value>
 void SpatialMap<T, Value>::queryBox(const Point<T>& min_corner, const Point<T>& max_corner, Vector_t<Box<T> >& ret, spatial::QueryType qt) const {
-  Vector_t<spatial::b_box<T>> vTmp;
-  spatial::SearchCallback_first<spatial::b_box<T> > callback(vTmp);
-  spatial::b_box<T> query_box(min_corner, max_corner);
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtreeMap.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtreeMap.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtreeMap.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtreeMap.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtreeMap.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtreeMap.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtreeMap.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
-  ret.reserve(vTmp.size());
-  for (const auto& b : vTmp)
-    ret.emplace_back(b.min_corner(), b.max_corner());
+  spatial::queryRtree(_rtreeMap, spatial::b_box<T>(min_corner, max_corner),
+                      [&] (const spatial::b_value<T, Value>& bv) { ret.emplace_back(bv.first.min_corner(), bv.first.max_corner()); }, qt);
 }
 
 template<typename T, typename Value>
 void SpatialMap<T, Value>::queryBox(const Box<T>& rect, Vector_t<Box<T> >& ret, spatial::QueryType qt) const {
-  Vector_t<spatial::b_box<T>> vTmp;
-  spatial::SearchCallback_first<spatial::b_box<T> > callback(vTmp);
-  spatial::b_box<T> query_box(rect.min_corner(), rect.max_corner());
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtreeMap.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtreeMap.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtreeMap.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtreeMap.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtreeMap.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtreeMap.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtreeMap.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
-  ret.reserve(vTmp.size());
-  for (const auto& b : vTmp)
-    ret.emplace_back(b.min_corner(), b.max_corner());
+  queryBox(rect.min_corner(), rect.max_corner(), ret, qt);
 }
 
 template<typename T, typename Value>
 void SpatialMap<T, Value>::queryBoth(const Box<T>& rect, Vector_t<Pair_t<Box<T>, Value> >& ret, spatial::QueryType qt) const {
-  Vector_t<spatial::b_value<T, Value>> vTmp;
-  spatial::SearchCallback<spatial::b_value<T, Value> > callback(vTmp);
-  spatial::b_box<T> query_box(rect.min_corner(), rect.max_corner());
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtreeMap.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtreeMap.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtreeMap.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtreeMap.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtreeMap.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtreeMap.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtreeMap.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
-  ret.reserve(vTmp.size());
-  for (const auto& p : vTmp) {
-    const auto& b = p.first;
-    ret.emplace_back(Box<T>(b.min_corner(), b.max_corner()), p.second);
-  }
+  queryBoth(rect.min_corner(), rect.max_corner(), ret, qt);
 }
 
 template<typename T, typename Value>
 void SpatialMap<T, Value>::queryBoth(const Point<T>& min_corner, const Point<T>& max_corner, Vector_t<Pair_t<Box<T>, Value> >& ret, spatial::QueryType qt) const {
-  Vector_t<spatial::b_value<T, Value>> vTmp;
-  spatial::SearchCallback<spatial::b_value<T, Value> > callback(vTmp);
-  spatial::b_box<T> query_box(min_corner, max_corner);
-  switch (qt) {
-    case spatial::QueryType::contains :
-      _rtreeMap.query(spatial::bgi::contains(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covered_by :
-      _rtreeMap.query(spatial::bgi::covered_by(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::covers :
-      _rtreeMap.query(spatial::bgi::covers(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::disjoint :
-      _rtreeMap.query(spatial::bgi::disjoint(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::intersects :
-      _rtreeMap.query(spatial::bgi::intersects(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::overlaps :
-      _rtreeMap.query(spatial::bgi::overlaps(query_box), boost::make_function_output_iterator(callback)); break;
-    case spatial::QueryType::within :
-      _rtreeMap.query(spatial::bgi::within(query_box), boost::make_function_output_iterator(callback)); break;
-    default:
-      assert(false);
-  }
-  ret.reserve(vTmp.size());
-  for (const auto& p : vTmp) {
-    const auto& b = p.first;
-    ret.emplace_back(Box<T>(b.min_corner(), b.max_corner()), p.second);
-  }
+  spatial::queryRtree(_rtreeMap, spatial::b_box<T>(min_corner, max_corner),
+                      [&] (const spatial::b_value<T, Value>& bv) {
+                        ret.emplace_back(Box<T>(bv.first.min_corner(), bv.first.max_corner()), bv.second);
+                      }, qt);
 }
 
 template<typename T, typename Value>
 bool SpatialMap<T, Value>::exist(const Box<T>& rect, spatial::QueryType qt) const {
-  Vector_t<Value> ret;
-  query(rect, ret, qt);
-  return !ret.empty();
+  return exist(rect.min_corner(), rect.max_corner(), qt);
 }
 
 template<typename T, typename Value>
 bool SpatialMap<T, Value>::exist(const Point<T>& min_corner, const Point<T>& max_corner, spatial::QueryType qt) const {
-  Vector_t<Value> ret;
-  query(min_corner, max_corner, ret, qt);
-  return !ret.empty();
+  return spatial::existRtree(_rtreeMap, spatial::b_box<T>(min_corner, max_corner),
+                             [] (const spatial::b_value<T, Value>& bv) { return true; }, qt);
+}
+
+template<typename T, typename Value>
+size_t SpatialMap<T, Value>::count(const Box<T>& rect, spatial::QueryType qt) const {
+  size_t cnt = 0;
+  spatial::queryRtree(_rtreeMap, spatial::b_box<T>(rect.min_corner(), rect.max_corner()),
+                      [&] (const spatial::b_value<T, Value>& bv) { ++cnt; }, qt);
+  return cnt;
+}
+
+template<typename T, typename Value>
+template<typename Visitor>
+void SpatialMap<T, Value>::visit(const Box<T>& rect, Visitor visitor, spatial::QueryType qt) const {
+  spatial::queryRtree(_rtreeMap, spatial::b_box<T>(rect.min_corner(), rect.max_corner()),
+                      [&] (const spatial::b_value<T, Value>& bv) {
+                        visitor(Box<T>(bv.first.min_corner(), bv.first.max_corner()), bv.second);
+                      }, qt);
+}
+
+template<typename T, typename Value>
+template<typename Pred>
+bool SpatialMap<T, Value>::exist(const Box<T>& rect, Pred pred, spatial::QueryType qt) const {
+  return spatial::existRtree(_rtreeMap, spatial::b_box<T>(rect.min_corner(), rect.max_corner()),
+                             [&] (const spatial::b_value<T, Value>& bv) {
+                               return pred(Box<T>(bv.first.min_corner(), bv.first.max_corner()), bv.second);
+                             }, qt);
 }
 
 template<typename T, typename Value>
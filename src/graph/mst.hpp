@@ -13,6 +13,10 @@
 #include <lemon/kruskal.h>
 
 #include "src/global/global.hpp"
+#include "src/ds/disjointSet.hpp"
+
+#include <queue>
+#include <tuple>
 
 PROJECT_NAMESPACE_START
 
@@ -60,6 +64,47 @@ class MinimumSpanningTree {
   Vector_t<Node>  _vNodes;
 };
 
+// Kruskal over the complete graph of numNodes nodes when an edge cost is
+// expensive to evaluate but a cheap lower bound of it is known.
+// Edges are taken in (cost, u, v) order with u < v, the exact cost of an
+// edge is evaluated only when its lower bound reaches the top of the queue.
+// lowerBound(u, v) <= cost(u, v) must hold.
+// return the cost of the mst
+template<typename CostType, typename LowerBoundFunc, typename CostFunc>
+CostType lazyKruskal(const Int_t numNodes, LowerBoundFunc lowerBound, CostFunc cost,
+                     Vector_t<Pair_t<Int_t, Int_t>>& vEdges) {
+  // (cost, u, v, bExact)
+  using Entry = std::tuple<CostType, Int_t, Int_t, bool>;
+  Vector_t<Entry> vEntries;
+  vEntries.reserve(numNodes * (numNodes - 1) / 2);
+  for (Int_t u = 0; u < numNodes; ++u) {
+    for (Int_t v = u + 1; v < numNodes; ++v) {
+      vEntries.emplace_back(lowerBound(u, v), u, v, false);
+    }
+  }
+  std::priority_queue<Entry, Vector_t<Entry>, std::greater<Entry>> pq(std::greater<Entry>(), std::move(vEntries));
+  DisjointSet ds(numNodes);
+  CostType totalCost = 0;
+  Int_t numEdges = 0;
+  while (!pq.empty() and numEdges < numNodes - 1) {
+    const Entry e = pq.top();
+    pq.pop();
+    const Int_t u = std::get<1>(e);
+    const Int_t v = std::get<2>(e);
+    if (ds.find(u) == ds.find(v))
+      continue;
+    if (!std::get<3>(e)) {
+      pq.emplace(cost(u, v), u, v, true);
+      continue;
+    }
+    ds.merge(u, v);
+    vEdges.emplace_back(u, v);
+    totalCost += std::get<0>(e);
+    ++numEdges;
+  }
+  return totalCost;
+}
+
 PROJECT_NAMESPACE_END
 
 #endif /// _GRAPH_MST_HPP_
@@ -23,7 +23,6 @@ PROJECT_NAMESPACE_START
 
 Anaroute::Anaroute(int argc, char** argv) {
  
-  std::srand(1234);
   util::showSysInfo();
 
   TimeUsage timer;
@@ -47,6 +46,14 @@ Anaroute::Anaroute(int argc, char** argv) {
   //const String_t outGuideGdsFile  = _args.get<String_t>("out_guide_gds");
   const String_t dumbFile         = _args.get<String_t>("fuck");
   const bool     bFlatten         = _args.exist("flatten");
+  const bool     bBinGrid         = _args.exist("bin_grid");
+  const Int_t    numThreads       = _args.get<Int_t>("threads");
+  const Int_t    numTrials        = _args.get<Int_t>("trials");
+  const bool     bOptimistic      = _args.exist("optimistic");
+  const bool     bPortfolio       = _args.exist("portfolio");
+  const Int_t    numPortThreads   = _args.get<Int_t>("portfolio_threads");
+  const bool     bBoxHeuristic    = _args.exist("box_heuristic");
+  const bool     bBidirectional   = _args.exist("bidirectional");
   
   bool bUseGrid = true;
   bool bUseSymFile = false;
@@ -72,6 +79,7 @@ Anaroute::Anaroute(int argc, char** argv) {
   //par.correctPinNBlkLoc(); // patch for placement bugs
 
   //cir.printInfo();
+  cir.setRoutedWireBinGrid(bBinGrid);
   cir.buildSpatial();
   cir.markBlks();
   cir.checkNetSymSelfSym();
@@ -104,7 +112,12 @@ Anaroute::Anaroute(int argc, char** argv) {
   timer.start(TimeUsage::PARTIAL);
   DrcMgr drc(cir);
   DrMgr dr(cir, drc);
-  dr.solve(bUseGrid, bUseSymFile);
+  dr.setOptimistic(bOptimistic);
+  dr.setPortfolio(bPortfolio);
+  dr.setNumPortfolioThreads(numPortThreads);
+  dr.setBoxHeuristic(bBoxHeuristic);
+  dr.setBidirectional(bBidirectional);
+  dr.solve(bUseGrid, bUseSymFile, numThreads, numTrials);
   timer.showUsage("Detailed Routing", TimeUsage::PARTIAL);
 
   // post processing
@@ -148,6 +161,14 @@ void Anaroute::parseArgs(int argc, char** argv) {
   _args.add<String_t>("out_guide", '\0', "output global routing guide file", false);
   //_args.add<String_t>("out_guide_gds", '\0', "output global routing guide file (gds)", false);
   _args.add("flatten", '\0', "flatten output GDS");
+  _args.add("bin_grid", '\0', "index routed wires with uniform bin grids instead of R-trees");
+  _args.add<Int_t>("threads", '\0', "number of threads for detailed routing", false, 1);
+  _args.add<Int_t>("trials", '\0', "number of detailed routing trials with different seeds", false, 1);
+  _args.add("optimistic", '\0', "route nets concurrently and validate them at commit (with threads > 1)");
+  _args.add("portfolio", '\0', "race a relaxed search against the strict one per net (with threads > 1)");
+  _args.add<Int_t>("portfolio_threads", '\0', "number of threads for the relaxed searches, 0 for the idle cores", false, 0);
+  _args.add("box_heuristic", '\0', "estimate the distance to the target bounding box instead of the nearest target");
+  _args.add("bidirectional", '\0', "search each subnet from both ends");
 
   _args.parse_check(argc, argv);
 }